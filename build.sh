@@ -1,4 +1,12 @@
 #!/bin/bash
-pushd build &> /dev/null
-	gcc -std=c++11 -fno-exceptions -D DEBUG=1 -D OS_LINUX=1 -o "asteroids" "../src/main.cpp" -l m -l X11 -l GL
-popd &> /dev/null
\ No newline at end of file
+# Pass 'headless' to build without a window or OpenGL, see src/null_gl.cpp
+if [ "$1" == "headless" ]; then
+	mkdir -p build
+	pushd build &> /dev/null
+		g++ -std=c++11 -fno-exceptions -O2 -D DEBUG=1 -D OS_LINUX=1 -D HEADLESS=1 -o "asteroids_headless" "../src/main.cpp" -l m -l pthread
+	popd &> /dev/null
+else
+	pushd build &> /dev/null
+		gcc -std=c++11 -fno-exceptions -D DEBUG=1 -D OS_LINUX=1 -o "asteroids" "../src/main.cpp" -l m -l X11 -l GL -l pthread
+	popd &> /dev/null
+fi
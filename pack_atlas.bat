@@ -0,0 +1,24 @@
+@echo off
+
+where cl >nul 2>nul
+if %ERRORLEVEL% neq 0 (
+    echo Importing compiler variables
+    call "C:\Program Files (x86)\Microsoft Visual Studio 14.0\VC\vcvarsall.bat" x64
+)
+
+if not exist build mkdir build
+pushd build
+    REM setargv.obj expands the sprite wildcard on the command line
+    cl /nologo /Fe"pack_atlas.exe" /EHa- /W4 /Ox ../src/tools/pack_atlas.cpp setargv.obj
+    set build_result=%ERRORLEVEL%
+popd
+
+if %build_result% equ 0 (
+    echo Packing sprite atlas
+
+    pushd data
+        ..\build\pack_atlas.exe sprites/atlas sprites/*.png
+    popd
+)
+
+echo Done
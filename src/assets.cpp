@@ -86,7 +86,7 @@ Sprite sprite_laser[LASER_COLOR_COUNT];
 Sprite sprite_smoke[9];
 
 Sprite* get_asteroid_sprite(Asteroid_Size size) {
-    return &sprite_asteroid[size][get_random_out_of(ASTEROID_TYPE_COUNT)];
+    return &sprite_asteroid[size][get_random_out_of(&spawn_random, ASTEROID_TYPE_COUNT)];
 }
 
 Sprite* get_ship_sprite(Ship_Type type, Ship_Color color) {
@@ -112,24 +112,34 @@ Sound sound_laser[2];
 Sound sound_enemy_fire[2];
 
 Sound* get_kill_sound() {
-    return &sound_kill[get_random_out_of(count_of(sound_kill))];
+    return &sound_kill[get_random_out_of(&sound_random, count_of(sound_kill))];
 }
 
 Sound* get_laser_sound() {
-    return &sound_laser[get_random_out_of(count_of(sound_laser))];
+    return &sound_laser[get_random_out_of(&sound_random, count_of(sound_laser))];
 }
 
 Sound* get_enemy_fire_sound() {
-    return &sound_enemy_fire[get_random_out_of(count_of(sound_enemy_fire))];
+    return &sound_enemy_fire[get_random_out_of(&sound_random, count_of(sound_enemy_fire))];
 }
 
 void load_assets() {
+    Heap_Tag previous_tag = set_heap_tag(HEAP_TAG_FONTS);
+
     font_arial        = load_font("c:/windows/fonts/arial.ttf");
     font_future       = load_font("fonts/future.ttf");
     font_starjedi     = load_font("fonts/starjedi.ttf");
     font_moonhouse    = load_font("fonts/moonhouse.ttf");
     font_nasalization = load_font("fonts/nasalization-rg.ttf");
 
+    // @note: The sizes the gui and the debug overlay draw every frame
+    warm_font(&font_nasalization, 32.0f);
+    warm_font(&font_nasalization, 45.0f);
+    warm_font(&font_arial,        18.0f);
+
+    set_heap_tag(HEAP_TAG_ASSETS);
+    load_sprite_atlas();
+
     sprite_background                                      = load_sprite("sprites/background.png");
     sprite_ui_ship                                         = load_sprite("sprites/ui_ship.png");
     sprite_thrust                                          = load_sprite("sprites/thrust.png");
@@ -176,6 +186,8 @@ void load_assets() {
         sprite_smoke[i] = load_sprite(format_string("sprites/smoke_%02u.png", i + 1));
     }
 
+    set_heap_tag(HEAP_TAG_SOUND);
+
     sound_music = load_sound("sounds/music.ogg");
     sound_spawn = load_sound("sounds/spawn.ogg");
     
@@ -190,4 +202,6 @@ void load_assets() {
     for (u32 i = 0; i < count_of(sound_enemy_fire); i++) {
         sound_enemy_fire[i] = load_sound(format_string("sounds/enemy_fire_%02u.ogg", i + 1));
     }
+
+    set_heap_tag(previous_tag);
 }
\ No newline at end of file
@@ -191,10 +191,100 @@ type* peek_next(Array_Iterator<type>* iterator) {
     return &iterator->array->elements[iterator->next];
 }
 
+//
+// Sorts an index array by 64 bit keys with a least significant digit radix sort,
+// which is stable and linear in the number of keys. The digit histograms for all
+// eight passes are built in a single read of the keys, and any pass where every
+// key shares the same digit is skipped, so keys that only use their low bits and a
+// few high bits cost two or three passes. The result is left in order, and
+// order_swap is only used as scratch.
+//
+
+const u32 RADIX_BITS        = 8;
+const u32 RADIX_DIGIT_COUNT = 1 << RADIX_BITS;
+const u32 RADIX_PASS_COUNT  = 64 / RADIX_BITS;
+
+void radix_sort(Array<u64>* keys, Array<u32>* order, Array<u32>* order_swap) {
+    u32 count = keys->count;
+
+    if (order->capacity      < count) allocate(order,      count);
+    if (order_swap->capacity < count) allocate(order_swap, count);
+
+    order->count      = count;
+    order_swap->count = count;
+
+    for (u32 i = 0; i < count; i++) {
+        order->elements[i] = i;
+    }
+
+    if (count < 2) return;
+
+    u32 digit_counts[RADIX_PASS_COUNT][RADIX_DIGIT_COUNT] = {};
+
+    for (u32 i = 0; i < count; i++) {
+        u64 key = keys->elements[i];
+
+        for (u32 pass = 0; pass < RADIX_PASS_COUNT; pass++) {
+            digit_counts[pass][(key >> (pass * RADIX_BITS)) & (RADIX_DIGIT_COUNT - 1)] += 1;
+        }
+    }
+
+    for (u32 pass = 0; pass < RADIX_PASS_COUNT; pass++) {
+        u32  shift  = pass * RADIX_BITS;
+        u32* counts = digit_counts[pass];
+
+        if (counts[(keys->elements[0] >> shift) & (RADIX_DIGIT_COUNT - 1)] == count) continue;
+
+        u32 offset = 0;
+        for (u32 digit = 0; digit < RADIX_DIGIT_COUNT; digit++) {
+            u32 digit_count = counts[digit];
+            
+            counts[digit] = offset;
+            offset += digit_count;
+        }
+
+        for (u32 i = 0; i < count; i++) {
+            u32 index = order->elements[i];
+            u32 digit = (keys->elements[index] >> shift) & (RADIX_DIGIT_COUNT - 1);
+
+            order_swap->elements[counts[digit]] = index;
+            counts[digit] += 1;
+        }
+
+        Array<u32> sorted = *order_swap;
+
+        *order_swap = *order;
+        *order      = sorted;
+    }
+}
+
+//
+// A bucket array stores its elements in fixed size buckets that are never moved,
+// so pointers to elements stay valid until they are removed. Each bucket tracks
+// its slots with a 64 bit occupancy mask and buckets that have a free slot are
+// linked into a free list, so adding an element never has to search. Every slot
+// also knows its bucket, which lets an element pointer be turned back into a
+// locator without iterating.
+//
+
+template<typename type, u32 size>
+struct Bucket;
+
+template<typename type, u32 size>
+struct Bucket_Slot {
+    type element;
+    Bucket<type, size>* bucket = null;
+};
+
 template<typename type, u32 size>
 struct Bucket {
-    type elements[size];
-    bool occupied[size] = {};
+    static_assert(size <= 64, "Bucket occupancy is stored in a 64 bit mask");
+
+    Bucket_Slot<type, size> slots[size];
+    u64 occupied = 0;
+
+    u32 array_index = 0;
+    Bucket<type, size>* next_free = null;
 };
 
 template<typename type, u32 size>
@@ -202,6 +292,8 @@ struct Bucket_Array {
     Allocator* allocator = &default_allocator;
 
     Array<Bucket<type, size>*> buckets;
+    Bucket<type, size>* first_free = null;
+
     u32 count = 0;
 };
 
@@ -211,47 +303,47 @@ struct Bucket_Locator {
 };
 
 template<typename type, u32 size>
-Bucket_Locator add(Bucket_Array<type, size>* bucket_array, type element) {
-    i32 array_index  = -1;
-    i32 bucket_index = -1;
-
-    for (u32 i = 0; i < bucket_array->buckets.count; i++) {
-        Bucket<type, size>* bucket = bucket_array->buckets[i];
-        
-        for (u32 j = 0; j < size; j++) {
-            if (bucket->occupied[j]) continue;
-
-            bucket_index = j;
-            break;
-        }
+u64 get_full_mask(Bucket<type, size>* bucket) {
+    return size == 64 ? ~((u64) 0) : (((u64) 1 << size) - 1);
+}
 
-        if (bucket_index != -1) {
-            array_index = i;
-            break;
-        }
-    }
+template<typename type, u32 size>
+bool is_occupied(Bucket<type, size>* bucket, u32 bucket_index) {
+    return (bucket->occupied & ((u64) 1 << bucket_index)) != 0;
+}
 
-    if (array_index == -1) {
+template<typename type, u32 size>
+Bucket_Locator add(Bucket_Array<type, size>* bucket_array, type element) {
+    if (!bucket_array->first_free) {
         // @note: There is a preprocessor bug passing generic types through the macro size_of...
 
         Bucket<type, size>* bucket = (Bucket<type, size>*) bucket_array->allocator->alloc(sizeof(Bucket<type, size>));
         construct(bucket);
 
-        array_index  = add(&bucket_array->buckets, bucket);
-        bucket_index = 0;
+        for (u32 i = 0; i < size; i++) {
+            bucket->slots[i].bucket = bucket;
+        }
+
+        bucket->array_index = add(&bucket_array->buckets, bucket);
+        bucket_array->first_free = bucket;
     }
 
-    assert(array_index  >= 0);
-    assert(bucket_index >= 0);
+    Bucket<type, size>* bucket = bucket_array->first_free;
+    u32 bucket_index = count_trailing_zeros(~bucket->occupied);
+
+    assert(bucket_index < size);
 
-    Bucket<type, size>* bucket = bucket_array->buckets[array_index];
+    bucket->slots[bucket_index].element = element;
+    bucket->occupied |= (u64) 1 << bucket_index;
 
-    bucket->elements[bucket_index] = element;
-    bucket->occupied[bucket_index] = true;
+    if (bucket->occupied == get_full_mask(bucket)) {
+        bucket_array->first_free = bucket->next_free;
+        bucket->next_free = null;
+    }
 
     Bucket_Locator bucket_locator;
 
-    bucket_locator.array_index  = array_index;
+    bucket_locator.array_index  = bucket->array_index;
     bucket_locator.bucket_index = bucket_index;
 
     bucket_array->count += 1;
@@ -262,20 +354,41 @@ Bucket_Locator add(Bucket_Array<type, size>* bucket_array, type element) {
 template<typename type, u32 size>
 void remove(Bucket_Array<type, size>* bucket_array, Bucket_Locator locator) {
     Bucket<type, size>* bucket = bucket_array->buckets[locator.array_index];
-    assert(bucket->occupied[locator.bucket_index]);
+    assert(is_occupied(bucket, locator.bucket_index));
 
     // @todo: Drop a bucket if there is a good amount of room in another bucket?
 
-    bucket->occupied[locator.bucket_index] = false;
+    if (bucket->occupied == get_full_mask(bucket)) {
+        bucket->next_free = bucket_array->first_free;
+        bucket_array->first_free = bucket;
+    }
+
+    bucket->occupied &= ~((u64) 1 << locator.bucket_index);
     bucket_array->count -= 1;
 }
 
 template<typename type, u32 size>
 type* get(Bucket_Array<type, size>* bucket_array, Bucket_Locator locator) {
     Bucket<type, size>* bucket = bucket_array->buckets[locator.array_index];
-    assert(bucket->occupied[locator.bucket_index]);
+    assert(is_occupied(bucket, locator.bucket_index));
+
+    return &bucket->slots[locator.bucket_index].element;
+}
+
+template<typename type, u32 size>
+Bucket_Locator get_locator(Bucket_Array<type, size>* bucket_array, type* element) {
+    // @note: The element is the first member of its slot, so the element address is the slot address
+    Bucket_Slot<type, size>* slot = (Bucket_Slot<type, size>*) element;
+    Bucket<type, size>* bucket = slot->bucket;
+
+    assert(bucket_array->buckets[bucket->array_index] == bucket);
+
+    Bucket_Locator locator;
 
-    return &bucket->elements[locator.bucket_index];
+    locator.array_index  = bucket->array_index;
+    locator.bucket_index = (u32) (slot - bucket->slots);
+
+    return locator;
 }
 
 template<typename type, u32 size>
@@ -294,6 +407,9 @@ void free(Bucket_Array<type, size>* bucket_array) {
     }
 
     free(&bucket_array->buckets);
+
+    bucket_array->first_free = null;
+    bucket_array->count      = 0;
 }
 
 template<typename type, u32 size>
@@ -307,26 +423,33 @@ struct Bucket_Iterator {
 };
 
 template<typename type, u32 size>
-Bucket_Iterator<type, size> make_iterator(Bucket_Array<type, size>* bucket_array) {
-    Bucket_Iterator<type, size> iterator;
-    iterator.bucket_array = bucket_array;
-
-    for (u32 i = 0; i < bucket_array->buckets.count; i++) {
+bool find_occupied(Bucket_Array<type, size>* bucket_array, u32 array_index, u32 bucket_start, Bucket_Locator* locator) {
+    for (u32 i = array_index; i < bucket_array->buckets.count; i++) {
         Bucket<type, size>* bucket = bucket_array->buckets[i];
-        
-        for (u32 j = 0; j < size; j++) {
-            if (!bucket->occupied[j]) continue;
 
-            iterator.next.array_index  = i;
-            iterator.next.bucket_index = j;
-            
-            iterator.has_next = true;
-            break;
+        u64 remaining = bucket->occupied;
+        if (i == array_index) {
+            remaining &= ~(((u64) 1 << bucket_start) - 1);
         }
 
-        if (iterator.has_next) break;
+        if (!remaining) continue;
+
+        locator->array_index  = i;
+        locator->bucket_index = count_trailing_zeros(remaining);
+
+        return true;
     }
 
+    return false;
+}
+
+template<typename type, u32 size>
+Bucket_Iterator<type, size> make_iterator(Bucket_Array<type, size>* bucket_array) {
+    Bucket_Iterator<type, size> iterator;
+    iterator.bucket_array = bucket_array;
+
+    iterator.has_next = find_occupied(bucket_array, 0, 0, &iterator.next);
+
     return iterator;
 }
 
@@ -337,27 +460,15 @@ type* get_next(Bucket_Iterator<type, size>* iterator) {
     type* element = get(iterator->bucket_array, iterator->next);
     iterator->current = iterator->next;
 
-    iterator->has_next = false;
-
-    for (u32 i = iterator->current.array_index; i < iterator->bucket_array->buckets.count; i++) {
-        Bucket<type, size>* bucket = iterator->bucket_array->buckets[i];
-        
-        u32 bucket_start = 0;
-        if (i == iterator->current.array_index) {
-            bucket_start = iterator->current.bucket_index + 1;
-        }
-
-        for (u32 j = bucket_start; j < size; j++) {
-            if (!bucket->occupied[j]) continue;
-
-            iterator->next.array_index  = i;
-            iterator->next.bucket_index = j;
-            
-            iterator->has_next = true;
-            break;
-        }
-
-        if (iterator->has_next) break;
+    if (iterator->current.bucket_index + 1 < size) {
+        iterator->has_next = find_occupied(
+            iterator->bucket_array, 
+            iterator->current.array_index, 
+            iterator->current.bucket_index + 1, 
+            &iterator->next);
+    }
+    else {
+        iterator->has_next = find_occupied(iterator->bucket_array, iterator->current.array_index + 1, 0, &iterator->next);
     }
 
     return element;
@@ -371,16 +482,5 @@ type* peek_next(Bucket_Iterator<type, size>* iterator) {
 
 template<typename type, u32 size>
 void remove(Bucket_Array<type, size>* bucket_array, type* element) {
-    bool was_removed = false;
-
-    for_each (type* it, bucket_array) {
-        if (it != element) continue;
-
-        remove(bucket_array, iterator.current);
-        was_removed = true;
-
-        break;
-    }
-
-    assert(was_removed);
+    remove(bucket_array, get_locator(bucket_array, element));
 }
\ No newline at end of file
@@ -53,7 +53,30 @@ void set_transform(Matrix4 transform) {
     glLoadMatrixf((f32*) &transform);
 }
 
+void set_transform(Transform2 transform) {
+    set_transform(to_matrix4(transform));
+}
+
+struct Draw_Stats {
+    u32 draw_calls = 0;
+    u32 vertices   = 0;
+};
+
+Draw_Stats draw_stats;
+Draw_Stats last_draw_stats;
+
+void reset_draw_stats() {
+    last_draw_stats = draw_stats;
+    draw_stats = Draw_Stats();
+}
+
+void count_draw_call(u32 vertices) {
+    draw_stats.draw_calls += 1;
+    draw_stats.vertices   += vertices;
+}
+
 void draw_rectangle(Rectangle2 rectangle, Color color, bool fill = true) {
+    count_draw_call(4);
     glBegin(fill ? GL_QUADS : GL_LINE_LOOP);
     glColor4f(color.r, color.g, color.b, color.a);
 
@@ -66,6 +89,7 @@ void draw_rectangle(Rectangle2 rectangle, Color color, bool fill = true) {
 }
 
 void draw_circle(Circle circle, Color color, bool fill = true) {
+    count_draw_call(360);
     glBegin(fill ? GL_QUADS : GL_LINE_LOOP);
     glColor4f(color.r, color.g, color.b, color.a);
 
@@ -80,17 +104,110 @@ void draw_circle(Circle circle, Color color, bool fill = true) {
     glEnd();
 }
 
-const utf32 CODEPOINT_START = 32;
-const utf32 CODEPOINT_COUNT = 96;
+//
+// Textured quads are drawn from client vertex arrays. A caller fills an array of
+// vertices four per quad, grouped by texture, and draws each group with one call.
+// The current transform applies, so text can be drawn in place.
+//
+
+struct Sprite_Vertex {
+    f32 x = 0.0f;
+    f32 y = 0.0f;
+    f32 u = 0.0f;
+    f32 v = 0.0f;
+
+    Color color;
+};
+
+void begin_quads(Sprite_Vertex* vertices) {
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+
+    glVertexPointer(2, GL_FLOAT, size_of(Sprite_Vertex), &vertices->x);
+    glTexCoordPointer(2, GL_FLOAT, size_of(Sprite_Vertex), &vertices->u);
+    glColorPointer(4, GL_FLOAT, size_of(Sprite_Vertex), &vertices->color);
+}
+
+void draw_quads(u32 texture, u32 first_quad, u32 quads_count) {
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glDrawArrays(GL_QUADS, first_quad * 4, quads_count * 4);
+
+    count_draw_call(quads_count * 4);
+}
+
+void end_quads() {
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+//
+// Glyphs for every font and size are packed on demand into a few shared atlas pages
+// with stbtt_pack, so a new size costs the glyphs it draws instead of a whole bitmap.
+// Each page keeps its bitmap and only the rows that changed are uploaded before a
+// draw. When every page is full the least recently used page is cleared and its
+// generation bumped, which turns the glyphs cached on it into misses that get
+// packed again on their next use.
+//
 
-const u32 BAKED_FONT_BITMAP_WIDTH  = 512;
-const u32 BAKED_FONT_BITMAP_HEIGHT = 512;
+const u32 GLYPH_PAGE_SIZE  = 512;
+const u32 GLYPH_PAGE_COUNT = 4;
 
-struct Baked_Font {
-    f32 size = 0.0f;
-    u32 texture_id = 0;
+const utf32 ASCII_CODEPOINT_COUNT = 128;
 
-    stbtt_bakedchar glyphs[CODEPOINT_COUNT];
+struct Glyph_Page {
+    u32 texture = 0;
+    u8* bitmap  = null;
+
+    stbtt_pack_context packer;
+
+    u32 generation = 0;
+    u32 last_used  = 0;
+
+    // @note: The rows that have to be uploaded, empty when dirty_top >= dirty_bottom
+    u32 dirty_top    = 0;
+    u32 dirty_bottom = 0;
+};
+
+struct Glyph_Atlas {
+    Glyph_Page pages[GLYPH_PAGE_COUNT];
+    u32 pages_count = 0;
+
+    // @note: The page new glyphs are packed into until it is full
+    u32 open_page = 0;
+
+    // @note: Bumped for every string so a page in use by the current string isn't evicted
+    u32 use_stamp = 0;
+
+    u32 evictions = 0;
+};
+
+Glyph_Atlas glyph_atlas;
+
+struct Glyph {
+    utf32 codepoint = 0;
+
+    u32 page       = 0;
+    u32 generation = 0;
+
+    stbtt_packedchar packed;
+};
+
+struct Font_Size {
+    f32 size  = 0.0f;
+    f32 scale = 0.0f;
+
+    f32 ascent   = 0.0f;
+    f32 descent  = 0.0f;
+    f32 line_gap = 0.0f;
+
+    // @note: One plus the index of an ascii codepoint's glyph, zero when it has none yet
+    u16 ascii_glyphs[ASCII_CODEPOINT_COUNT];
+
+    Array<Glyph> glyphs;
 };
 
 struct Font {
@@ -100,7 +217,7 @@ struct Font {
     void* ttf_data  = null;
 
     stbtt_fontinfo info;
-    Array<Baked_Font> baked;
+    Array<Font_Size> sizes;
 };
 
 Font load_font(utf8* file_name) {
@@ -121,160 +238,440 @@ Font load_font(utf8* file_name) {
     return font;
 }
 
-f32 get_font_ascent(Font* font, f32 size) {
-    f32 result = 0.0f;
+void reset_glyph_page(Glyph_Page* page) {
+    if (page->bitmap) {
+        stbtt_PackEnd(&page->packer);
+        page->generation += 1;
+    }
+    else {
+        glGenTextures(1, &page->texture);
+        page->bitmap = (u8*) heap_alloc(GLYPH_PAGE_SIZE * GLYPH_PAGE_SIZE);
+    }
 
-    if (font->is_valid) {
-        f32 font_scale = stbtt_ScaleForPixelHeight(&font->info, size);
-        
-        i32 ascent;
-        stbtt_GetFontVMetrics(&font->info, &ascent, null, null);
+    // @note: Clears the bitmap too
+    i32 result = stbtt_PackBegin(&page->packer, page->bitmap, GLYPH_PAGE_SIZE, GLYPH_PAGE_SIZE, 0, 1, null);
+    assert(result);
+
+    if (page->generation == 0) {
+        glBindTexture(GL_TEXTURE_2D, page->texture);
+
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, GLYPH_PAGE_SIZE, GLYPH_PAGE_SIZE, 0, GL_ALPHA, GL_UNSIGNED_BYTE, page->bitmap);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 
-        result = ascent * font_scale;
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        page->dirty_top    = 0;
+        page->dirty_bottom = 0;
+    }
+    else {
+        page->dirty_top    = 0;
+        page->dirty_bottom = GLYPH_PAGE_SIZE;
+    }
+}
+
+bool pack_glyph(Font* font, f32 size, Glyph* glyph, u32 page_index) {
+    Glyph_Page* page = &glyph_atlas.pages[page_index];
+
+    if (!stbtt_PackFontRange(&page->packer, (u8*) font->ttf_data, 0, size, glyph->codepoint, 1, &glyph->packed)) {
+        return false;
     }
 
-    return result;
+    glyph->page       = page_index;
+    glyph->generation = page->generation;
+
+    if (page->dirty_top >= page->dirty_bottom) {
+        page->dirty_top    = glyph->packed.y0;
+        page->dirty_bottom = glyph->packed.y1;
+    }
+    else {
+        if (glyph->packed.y0 < page->dirty_top)    page->dirty_top    = glyph->packed.y0;
+        if (glyph->packed.y1 > page->dirty_bottom) page->dirty_bottom = glyph->packed.y1;
+    }
+
+    return true;
 }
 
-f32 get_font_descent(Font* font, f32 size) {
-    f32 result = 0.0f;
+bool pack_glyph(Font* font, f32 size, Glyph* glyph) {
+    Glyph_Atlas* atlas = &glyph_atlas;
+    Heap_Tag previous_tag = set_heap_tag(HEAP_TAG_FONTS);
 
-    if (font->is_valid) {
-        f32 font_scale = stbtt_ScaleForPixelHeight(&font->info, size);
-        
-        i32 descent;
-        stbtt_GetFontVMetrics(&font->info, null, &descent, null);
+    bool packed = false;
 
-        result = -descent * font_scale;
+    if (atlas->pages_count) {
+        packed = pack_glyph(font, size, glyph, atlas->open_page);
     }
 
-    return result;
+    if (!packed && atlas->pages_count < GLYPH_PAGE_COUNT) {
+        atlas->open_page = atlas->pages_count++;
+        reset_glyph_page(&atlas->pages[atlas->open_page]);
+
+        packed = pack_glyph(font, size, glyph, atlas->open_page);
+    }
+
+    if (!packed) {
+        u32 oldest_page = GLYPH_PAGE_COUNT;
+
+        for (u32 i = 0; i < atlas->pages_count; i++) {
+            Glyph_Page* page = &atlas->pages[i];
+            if (page->last_used == atlas->use_stamp) continue;
+
+            if (oldest_page == GLYPH_PAGE_COUNT || page->last_used < atlas->pages[oldest_page].last_used) {
+                oldest_page = i;
+            }
+        }
+
+        if (oldest_page != GLYPH_PAGE_COUNT) {
+            atlas->open_page = oldest_page;
+            atlas->evictions += 1;
+
+            reset_glyph_page(&atlas->pages[oldest_page]);
+            packed = pack_glyph(font, size, glyph, oldest_page);
+        }
+    }
+
+    set_heap_tag(previous_tag);
+    return packed;
 }
 
-f32 get_font_line_gap(Font* font, f32 size) {
-    f32 result = 0.0f;
+Font_Size* get_font_size(Font* font, f32 size) {
+    for_each (Font_Size* it, &font->sizes) {
+        if (it->size == size) return it;
+    }
 
-    if (font->is_valid) {
-        f32 font_scale = stbtt_ScaleForPixelHeight(&font->info, size);
+    Heap_Tag previous_tag = set_heap_tag(HEAP_TAG_FONTS);
 
-        i32 line_gap;
-        stbtt_GetFontVMetrics(&font->info, null, null, &line_gap);
+    Font_Size* font_size = next(&font->sizes);
+    font_size->size  = size;
+    font_size->scale = stbtt_ScaleForPixelHeight(&font->info, size);
 
-        result = line_gap * font_scale;
+    i32 ascent, descent, line_gap;
+    stbtt_GetFontVMetrics(&font->info, &ascent, &descent, &line_gap);
+
+    font_size->ascent   =  ascent   * font_size->scale;
+    font_size->descent  = -descent  * font_size->scale;
+    font_size->line_gap =  line_gap * font_size->scale;
+
+    memset(font_size->ascii_glyphs, 0, size_of(font_size->ascii_glyphs));
+
+    set_heap_tag(previous_tag);
+    return font_size;
+}
+
+// @note: Packs the glyph again if its page was evicted since it was last used
+Glyph* use_glyph(Font* font, Font_Size* font_size, Glyph* glyph) {
+    if (glyph->generation != glyph_atlas.pages[glyph->page].generation) {
+        if (!pack_glyph(font, font_size->size, glyph)) return null;
     }
 
-    return result;
+    glyph_atlas.pages[glyph->page].last_used = glyph_atlas.use_stamp;
+    return glyph;
 }
 
-f32 get_text_width(Font* font, f32 size, utf8* text) {
+Glyph* get_glyph(Font* font, Font_Size* font_size, utf32 codepoint) {
+    Glyph* glyph = null;
+
+    if (codepoint < ASCII_CODEPOINT_COUNT) {
+        u16 slot = font_size->ascii_glyphs[codepoint];
+        if (slot) glyph = &font_size->glyphs[slot - 1];
+    }
+    else {
+        for_each (Glyph* it, &font_size->glyphs) {
+            if (it->codepoint != codepoint) continue;
+
+            glyph = it;
+            break;
+        }
+    }
+
+    if (!glyph) {
+        Heap_Tag previous_tag = set_heap_tag(HEAP_TAG_FONTS);
+        glyph = next(&font_size->glyphs);
+        set_heap_tag(previous_tag);
+
+        glyph->codepoint = codepoint;
+        glyph->generation = (u32) -1;
+
+        if (codepoint < ASCII_CODEPOINT_COUNT) {
+            font_size->ascii_glyphs[codepoint] = (u16) font_size->glyphs.count;
+        }
+    }
+
+    return use_glyph(font, font_size, glyph);
+}
+
+// @note: Packs the printable ascii glyphs up front so the first frames that draw them don't stall
+void warm_font(Font* font, f32 size) {
+    if (!font->is_valid) return;
+
+    glyph_atlas.use_stamp += 1;
+
+    Font_Size* font_size = get_font_size(font, size);
+    for (utf32 codepoint = 32; codepoint < 127; codepoint++) {
+        get_glyph(font, font_size, codepoint);
+    }
+}
+
+f32 get_font_ascent(Font* font, f32 size) {
+    if (!font->is_valid) return 0.0f;
+    return get_font_size(font, size)->ascent;
+}
+
+f32 get_font_descent(Font* font, f32 size) {
+    if (!font->is_valid) return 0.0f;
+    return get_font_size(font, size)->descent;
+}
+
+f32 get_font_line_gap(Font* font, f32 size) {
     if (!font->is_valid) return 0.0f;
+    return get_font_size(font, size)->line_gap;
+}
+
+//
+// Text is shaped into a run once and the run is cached, keyed by the font, the size
+// and the string. A run keeps the width (advances plus kerning) and the quad of each
+// glyph relative to the pen start, so a label that doesn't change is neither measured
+// nor laid out again, only its texture coordinates are read from the atlas when it
+// draws. The cache is set associative and replaces the least recently used run in a
+// set, so strings that change every frame only churn their own slots.
+//
+
+const u32 TEXT_RUN_CACHE_SETS = 64;
+const u32 TEXT_RUN_CACHE_WAYS = 4;
+
+struct Shaped_Glyph {
+    u32 glyph = 0;
+
+    f32 x0 = 0.0f;
+    f32 y0 = 0.0f;
+    f32 x1 = 0.0f;
+    f32 y1 = 0.0f;
+};
 
-    f32 font_scale = stbtt_ScaleForPixelHeight(&font->info, size);
+struct Text_Run {
+    Font* font = null;
+    f32   size = 0.0f;
+    u32   hash = 0;
+
+    Array<utf8> text;
 
     f32 width = 0.0f;
-    while (*text) {
-        utf32 codepoint = *text;
+    Array<Shaped_Glyph> glyphs;
+
+    u32 last_used = 0;
+};
+
+struct Text_Run_Cache {
+    Text_Run runs[TEXT_RUN_CACHE_SETS][TEXT_RUN_CACHE_WAYS];
+    u32 use_stamp = 0;
+
+    u32 hits   = 0;
+    u32 misses = 0;
+};
+
+Text_Run_Cache text_run_cache;
+
+u32 hash_text_run(Font* font, f32 size, utf8* text) {
+    u32 size_bits;
+    memcpy(&size_bits, &size, size_of(size_bits));
+
+    u32 result = hash(text);
+    result = (result * 31) + (u32) ((uintptr_t) font >> 4);
+    result = (result * 31) + size_bits;
+
+    return result;
+}
+
+void shape_text_run(Text_Run* run, utf8* text) {
+    Font* font = run->font;
+    Font_Size* font_size = get_font_size(font, run->size);
 
+    run->width = 0.0f;
+    run->glyphs.count = 0;
+
+    glyph_atlas.use_stamp += 1;
+
+    f32 position_x = 0.0f;
+    f32 position_y = 0.0f;
+
+    utf8* cursor = text;
+    utf32 codepoint = *cursor ? decode_utf8(&cursor) : 0;
+
+    while (codepoint) {
         i32 advance_width, left_side_bearing;
         stbtt_GetCodepointHMetrics(&font->info, codepoint, &advance_width, &left_side_bearing);
 
-        width += advance_width * font_scale;
-        
-        utf32 next_codepoint = *(text + 1);
+        run->width += advance_width * font_size->scale;
+
+        utf32 next_codepoint = *cursor ? decode_utf8(&cursor) : 0;
         if (next_codepoint) {
             f32 kern_advance = (f32) stbtt_GetCodepointKernAdvance(&font->info, codepoint, next_codepoint);
-            width += kern_advance * font_scale;
+            run->width += kern_advance * font_size->scale;
         }
 
-        text += 1;
+        // @note: A glyph that can't be packed is left out of the run
+        Glyph* glyph = get_glyph(font, font_size, codepoint);
+        if (glyph) {
+            stbtt_aligned_quad quad;
+            stbtt_GetPackedQuad(&glyph->packed, GLYPH_PAGE_SIZE, GLYPH_PAGE_SIZE, 0, &position_x, &position_y, &quad, 1);
+
+            Shaped_Glyph* shaped = next(&run->glyphs);
+
+            shaped->glyph = (u32) (glyph - font_size->glyphs.elements);
+            shaped->x0    = quad.x0;
+            shaped->y0    = quad.y0;
+            shaped->x1    = quad.x1;
+            shaped->y1    = quad.y1;
+        }
+
+        codepoint = next_codepoint;
+    }
+}
+
+Text_Run* get_text_run(Font* font, f32 size, utf8* text) {
+    Text_Run_Cache* cache = &text_run_cache;
+    cache->use_stamp += 1;
+
+    u32 run_hash = hash_text_run(font, size, text);
+    Text_Run* set = cache->runs[run_hash % TEXT_RUN_CACHE_SETS];
+
+    Text_Run* oldest_run = &set[0];
+
+    for (u32 i = 0; i < TEXT_RUN_CACHE_WAYS; i++) {
+        Text_Run* run = &set[i];
+
+        if (run->font == font && run->size == size && run->hash == run_hash && run->text.count && compare(run->text.elements, text)) {
+            cache->hits += 1;
+
+            run->last_used = cache->use_stamp;
+            return run;
+        }
+
+        if (run->last_used < oldest_run->last_used) oldest_run = run;
+    }
+
+    cache->misses += 1;
+
+    Heap_Tag previous_tag = set_heap_tag(HEAP_TAG_FONTS);
+
+    Text_Run* run = oldest_run;
+
+    run->font      = font;
+    run->size      = size;
+    run->hash      = run_hash;
+    run->last_used = cache->use_stamp;
+
+    // @note: The length counts the terminator
+    u32 length = get_length(text);
+    run->text.count = 0;
+
+    if (run->text.capacity < length) allocate(&run->text, length);
+    run->text.count = length;
+
+    memcpy(run->text.elements, text, length);
+
+    shape_text_run(run, text);
+
+    set_heap_tag(previous_tag);
+    return run;
+}
+
+f32 get_text_width(Font* font, f32 size, utf8* text) {
+    if (!font->is_valid) return 0.0f;
+    return get_text_run(font, size, text)->width;
+}
+
+void upload_glyph_pages() {
+    for (u32 i = 0; i < glyph_atlas.pages_count; i++) {
+        Glyph_Page* page = &glyph_atlas.pages[i];
+        if (page->dirty_top >= page->dirty_bottom) continue;
+
+        glBindTexture(GL_TEXTURE_2D, page->texture);
+        glTexSubImage2D(
+            GL_TEXTURE_2D, 
+            0, 
+            0, 
+            page->dirty_top, 
+            GLYPH_PAGE_SIZE, 
+            page->dirty_bottom - page->dirty_top, 
+            GL_ALPHA, 
+            GL_UNSIGNED_BYTE, 
+            page->bitmap + (page->dirty_top * GLYPH_PAGE_SIZE));
+
+        page->dirty_top    = 0;
+        page->dirty_bottom = 0;
     }
 
-    return width;
+    glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 void draw_text(Font* font, f32 size, utf8* text, Color color = make_color(1.0f, 1.0f, 1.0f)) {
     if (!font->is_valid) return;
 
-    Baked_Font* baked_font = null;
-    for_each (Baked_Font* it, &font->baked) {
-        if (it->size != size) continue;
+    Text_Run* run = get_text_run(font, size, text);
+    if (!run->glyphs.count) return;
 
-        baked_font = it;
-        break;
-    }
+    glyph_atlas.use_stamp += 1;
+    Font_Size* font_size = get_font_size(font, size);
 
-    if (!baked_font) {
-        baked_font = next(&font->baked);
-        baked_font->size = size;
+    Array<Sprite_Vertex> vertices;
+    vertices.allocator = &temp_allocator;
 
-        u32 temp_start = platform.temp_memory_allocated;
-        void* bitmap = temp_alloc(BAKED_FONT_BITMAP_WIDTH * BAKED_FONT_BITMAP_HEIGHT);
-        
-        i32 result = stbtt_BakeFontBitmap(
-            (u8*) font->ttf_data, 
-            0, 
-            size, 
-            (u8*) bitmap, 
-            BAKED_FONT_BITMAP_WIDTH, 
-            BAKED_FONT_BITMAP_HEIGHT, 
-            CODEPOINT_START, 
-            CODEPOINT_COUNT, 
-            baked_font->glyphs);
+    Array<u32> pages;
+    pages.allocator = &temp_allocator;
 
-        assert(result > 0);
+    allocate(&vertices, run->glyphs.count * 4);
+    allocate(&pages,    run->glyphs.count);
 
-        glGenTextures(1, &baked_font->texture_id);
-        glBindTexture(GL_TEXTURE_2D, baked_font->texture_id);
+    for_each (Shaped_Glyph* shaped, &run->glyphs) {
+        Glyph* glyph = use_glyph(font, font_size, &font_size->glyphs[shaped->glyph]);
+        if (!glyph) continue;
 
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, BAKED_FONT_BITMAP_WIDTH, BAKED_FONT_BITMAP_HEIGHT, 0, GL_ALPHA, GL_UNSIGNED_BYTE, bitmap);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        f32 s0 = glyph->packed.x0 / (f32) GLYPH_PAGE_SIZE;
+        f32 t0 = glyph->packed.y0 / (f32) GLYPH_PAGE_SIZE;
+        f32 s1 = glyph->packed.x1 / (f32) GLYPH_PAGE_SIZE;
+        f32 t1 = glyph->packed.y1 / (f32) GLYPH_PAGE_SIZE;
 
-        glBindTexture(GL_TEXTURE_2D, 0);
-        platform.temp_memory_allocated = temp_start;
+        f32 corner_x[4] = { shaped->x0, shaped->x1, shaped->x1, shaped->x0 };
+        f32 corner_y[4] = { shaped->y0, shaped->y0, shaped->y1, shaped->y1 };
+        f32 corner_u[4] = { s0, s1, s1, s0 };
+        f32 corner_v[4] = { t0, t0, t1, t1 };
+
+        for (u32 i = 0; i < 4; i++) {
+            Sprite_Vertex* vertex = next(&vertices);
+
+            vertex->x     =  corner_x[i];
+            vertex->y     = -corner_y[i];
+            vertex->u     =  corner_u[i];
+            vertex->v     =  corner_v[i];
+            vertex->color = color;
+        }
+
+        add(&pages, glyph->page);
     }
 
-    glBindTexture(GL_TEXTURE_2D, baked_font->texture_id);
-    glBegin(GL_QUADS);
+    if (!pages.count) return;
 
-    glColor4f(color.r, color.g, color.b, color.a);
+    upload_glyph_pages();
 
-    f32 position_x = 0;
-    f32 position_y = 0;
+    //
+    // A string nearly always sits on one page. When it doesn't, its quads are drawn
+    // one page at a time, a glyph's quad only depends on its own pen position.
+    //
 
-    utf8* cursor = text;
-    while (*cursor) {
-        utf32 codepoint = *cursor;
-        if (CODEPOINT_START <= codepoint && codepoint < CODEPOINT_START + CODEPOINT_COUNT) {
-            stbtt_aligned_quad baked_quad;
-            
-            stbtt_GetBakedQuad(
-                baked_font->glyphs, 
-                BAKED_FONT_BITMAP_WIDTH, 
-                BAKED_FONT_BITMAP_HEIGHT, 
-                codepoint - CODEPOINT_START, 
-                &position_x, 
-                &position_y, 
-                &baked_quad, 
-                1);
-
-            glTexCoord2f(baked_quad.s0, baked_quad.t0);
-            glVertex2f(baked_quad.x0, -baked_quad.y0);
-
-            glTexCoord2f(baked_quad.s1, baked_quad.t0);
-            glVertex2f(baked_quad.x1, -baked_quad.y0);
-
-            glTexCoord2f(baked_quad.s1, baked_quad.t1);
-            glVertex2f(baked_quad.x1, -baked_quad.y1);
-
-            glTexCoord2f(baked_quad.s0, baked_quad.t1);
-            glVertex2f(baked_quad.x0, -baked_quad.y1);
+    begin_quads(vertices.elements);
+
+    u32 run_start = 0;
+    while (run_start < pages.count) {
+        u32 run_end = run_start + 1;
+        while (run_end < pages.count && pages[run_end] == pages[run_start]) {
+            run_end += 1;
         }
 
-        cursor += 1;
+        draw_quads(glyph_atlas.pages[pages[run_start]].texture, run_start, run_end - run_start);
+        run_start = run_end;
     }
 
-    glEnd();
-    glBindTexture(GL_TEXTURE_2D, 0);
+    end_quads();
 }
 
 struct Sprite {
@@ -284,22 +681,155 @@ struct Sprite {
     u32 width   = 0;
     u32 height  = 0;
     f32 aspect  = 0.0f;
+
+    // @note: The part of the texture the sprite covers, v0 is the top row of the image
+    f32 u0 = 0.0f;
+    f32 v0 = 0.0f;
+    f32 u1 = 1.0f;
+    f32 v1 = 1.0f;
 };
 
+//
+// Sprites packed offline by the atlas packer (src/tools/pack_atlas.cpp) share the
+// texture of their atlas page, so a sprite batch of atlased sprites only breaks on
+// sprite order. A sprite that isn't in the atlas is loaded from its own file.
+//
+
+#define SPRITE_ATLAS_FILE_NAME "sprites/atlas.txt"
+
+struct Atlas_Page {
+    u32 texture = 0;
+    u32 width   = 0;
+    u32 height  = 0;
+};
+
+struct Atlas_Sprite {
+    utf8 file_name[128];
+
+    u32 page   = 0;
+    u32 x      = 0;
+    u32 y      = 0;
+    u32 width  = 0;
+    u32 height = 0;
+};
+
+struct Sprite_Atlas {
+    Array<Atlas_Page>   pages;
+    Array<Atlas_Sprite> sprites;
+};
+
+Sprite_Atlas sprite_atlas;
+
+u32 make_texture(u8* image, u32 width, u32 height) {
+    u32 texture = 0;
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+void load_sprite_atlas() {
+    FILE* atlas_file = fopen(SPRITE_ATLAS_FILE_NAME, "rb");
+    if (!atlas_file) {
+        printf("No sprite atlas, loading sprites individually\n");
+        return;
+    }
+
+    u32 page_count = 0;
+    fscanf(atlas_file, "pages=%u\n", &page_count);
+
+    for (u32 i = 0; i < page_count; i++) {
+        utf8 page_file_name[128];
+        Atlas_Page page;
+
+        fscanf(atlas_file, "page=%127s %u %u\n", page_file_name, &page.width, &page.height);
+
+        i32 width  = 0;
+        i32 height = 0;
+
+        u8* image = stbi_load(page_file_name, &width, &height, null, 4);
+        if (!image || (u32) width != page.width || (u32) height != page.height) {
+            printf("Failed to load sprite atlas page '%s'\n", page_file_name);
+
+            if (image) stbi_image_free(image);
+            sprite_atlas.sprites.count = 0;
+
+            fclose(atlas_file);
+            return;
+        }
+
+        page.texture = make_texture(image, page.width, page.height);
+        stbi_image_free(image);
+
+        add(&sprite_atlas.pages, page);
+        printf("Loaded sprite atlas page '%s'\n", page_file_name);
+    }
+
+    u32 sprite_count = 0;
+    fscanf(atlas_file, "sprites=%u\n", &sprite_count);
+
+    for (u32 i = 0; i < sprite_count; i++) {
+        Atlas_Sprite atlas_sprite;
+
+        i32 read = fscanf(
+            atlas_file, 
+            "sprite=%127s %u %u %u %u %u\n", 
+            atlas_sprite.file_name, 
+            &atlas_sprite.page, 
+            &atlas_sprite.x, 
+            &atlas_sprite.y, 
+            &atlas_sprite.width, 
+            &atlas_sprite.height);
+
+        if (read != 6) break;
+        if (atlas_sprite.page >= sprite_atlas.pages.count) continue;
+
+        add(&sprite_atlas.sprites, atlas_sprite);
+    }
+
+    fclose(atlas_file);
+}
+
+Atlas_Sprite* find_atlas_sprite(utf8* file_name) {
+    for (u32 i = 0; i < sprite_atlas.sprites.count; i++) {
+        Atlas_Sprite* atlas_sprite = &sprite_atlas.sprites[i];
+        if (compare(atlas_sprite->file_name, file_name)) return atlas_sprite;
+    }
+
+    return null;
+}
+
 Sprite load_sprite(utf8* file_name) {
     Sprite sprite;
 
+    Atlas_Sprite* atlas_sprite = find_atlas_sprite(file_name);
+    if (atlas_sprite) {
+        Atlas_Page* page = &sprite_atlas.pages[atlas_sprite->page];
+
+        sprite.texture = page->texture;
+        sprite.width   = atlas_sprite->width;
+        sprite.height  = atlas_sprite->height;
+        sprite.aspect  = (f32) sprite.width / (f32) sprite.height;
+
+        sprite.u0 = (f32) atlas_sprite->x / (f32) page->width;
+        sprite.v0 = (f32) atlas_sprite->y / (f32) page->height;
+        sprite.u1 = (f32) (atlas_sprite->x + atlas_sprite->width)  / (f32) page->width;
+        sprite.v1 = (f32) (atlas_sprite->y + atlas_sprite->height) / (f32) page->height;
+
+        sprite.is_valid = true;
+        return sprite;
+    }
+
     u8* image = stbi_load(file_name, (i32*) &sprite.width, (i32*) &sprite.height, null, 4);
     sprite.aspect = (f32) sprite.width / (f32) sprite.height;
 
     if (image) {
-        glGenTextures(1, &sprite.texture);
-        glBindTexture(GL_TEXTURE_2D, sprite.texture);
-
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, sprite.width, sprite.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-
-        glBindTexture(GL_TEXTURE_2D, 0);
+        sprite.texture = make_texture(image, sprite.width, sprite.height);
         stbi_image_free(image);
 
         printf("Loaded sprite '%s'\n", file_name);
@@ -326,6 +856,8 @@ void draw_sprite(Sprite* sprite, f32 height, f32 opacity = 1.0f, bool center = t
         return;
     }
 
+    count_draw_call(4);
+
     glBindTexture(GL_TEXTURE_2D, sprite->texture);
     glBegin(GL_QUADS);
 
@@ -341,22 +873,242 @@ void draw_sprite(Sprite* sprite, f32 height, f32 opacity = 1.0f, bool center = t
         y -= height / 2.0f;
     }
 
-    glTexCoord2f(0.0f, 1.0f);
+    glTexCoord2f(sprite->u0, sprite->v1);
     glVertex2f(x, y);
 
-    glTexCoord2f(1.0f, 1.0f);
+    glTexCoord2f(sprite->u1, sprite->v1);
     glVertex2f(x + width, y);
 
-    glTexCoord2f(1.0f, 0.0f);
+    glTexCoord2f(sprite->u1, sprite->v0);
     glVertex2f(x + width, y + height);
 
-    glTexCoord2f(0.0f, 0.0f);
+    glTexCoord2f(sprite->u0, sprite->v0);
     glVertex2f(x, y + height);
 
     glEnd();
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
+//
+// The sprite batch collects sprite quads for a pass (the background tiles and the
+// entities), transforms their vertices on the CPU and draws them from a vertex
+// array that persists across frames. At flush the quads are ordered by sprite order
+// and then by texture, so every run of quads that share a texture is one draw call.
+// Quads with the same order and texture keep the order they were added in.
+//
+
+struct Sprite_Batch {
+    Array<Sprite_Vertex> vertices;
+    Array<Sprite_Vertex> sorted_vertices;
+
+    Array<u64> keys;
+    Array<u32> order;
+    Array<u32> order_swap;
+};
+
+Sprite_Batch sprite_batch;
+
+void batch_sprite(Sprite* sprite, Transform2 transform, f32 height, f32 opacity = 1.0f, bool center = true, i32 order = 0) {
+    f32 x = 0.0f;
+    f32 y = 0.0f;
+
+    f32 width = height;
+    u32 texture = 0;
+
+    f32 u0 = 0.0f;
+    f32 v0 = 0.0f;
+    f32 u1 = 1.0f;
+    f32 v1 = 1.0f;
+
+    if (sprite && sprite->is_valid) {
+        width   = get_sprite_width(sprite, height);
+        texture = sprite->texture;
+
+        u0 = sprite->u0;
+        v0 = sprite->v0;
+        u1 = sprite->u1;
+        v1 = sprite->v1;
+    }
+
+    if (center) {
+        x -= width  / 2.0f;
+        y -= height / 2.0f;
+    }
+
+    Vector2 corners[4] = {
+        make_vector2(x,         y),
+        make_vector2(x + width, y),
+        make_vector2(x + width, y + height),
+        make_vector2(x,         y + height)
+    };
+
+    f32 texture_u[4] = { u0, u1, u1, u0 };
+    f32 texture_v[4] = { v1, v1, v0, v0 };
+
+    for (u32 i = 0; i < 4; i++) {
+        Vector2 position = transform * corners[i];
+
+        Sprite_Vertex vertex;
+
+        vertex.x     = position.x;
+        vertex.y     = position.y;
+        vertex.u     = texture_u[i];
+        vertex.v     = texture_v[i];
+        vertex.color = make_color(1.0f, 1.0f, 1.0f, opacity);
+
+        add(&sprite_batch.vertices, vertex);
+    }
+
+    // @note: The order is biased so negative orders sort below positive ones
+    u64 key = ((u64) ((u32) order ^ 0x80000000) << 32) | texture;
+    add(&sprite_batch.keys, key);
+}
+
+void sort_sprite_batch() {
+    radix_sort(&sprite_batch.keys, &sprite_batch.order, &sprite_batch.order_swap);
+}
+
+void flush_sprite_batch() {
+    u32 quads_count = sprite_batch.keys.count;
+    if (!quads_count) return;
+
+    sort_sprite_batch();
+
+    sprite_batch.sorted_vertices.count = 0;
+
+    for (u32 i = 0; i < quads_count; i++) {
+        u32 quad = sprite_batch.order[i];
+
+        for (u32 j = 0; j < 4; j++) {
+            add(&sprite_batch.sorted_vertices, sprite_batch.vertices[(quad * 4) + j]);
+        }
+    }
+
+    set_transform(make_identity_matrix());
+    begin_quads(sprite_batch.sorted_vertices.elements);
+
+    u32 run_start = 0;
+    while (run_start < quads_count) {
+        u32 texture = (u32) sprite_batch.keys[sprite_batch.order[run_start]];
+        
+        u32 run_end = run_start + 1;
+        while (run_end < quads_count && (u32) sprite_batch.keys[sprite_batch.order[run_end]] == texture) {
+            run_end += 1;
+        }
+
+        draw_quads(texture, run_start, run_end - run_start);
+        run_start = run_end;
+    }
+
+    end_quads();
+
+    sprite_batch.vertices.count = 0;
+    sprite_batch.keys.count     = 0;
+}
+
+//
+// Sprite instances are for many small unrotated sprites drawn from one table, like
+// the smoke particles. An instance is only a position, a size, an opacity and an
+// index into the table, so filling them is a straight copy. They are grouped by
+// texture and every group is one draw call. The game only asks for a GL 1.x context,
+// so the quads are expanded on the CPU here, which is also what the headless
+// backend gets, but without the transform the sprite batch multiplies every
+// corner by.
+//
+
+struct Sprite_Instance {
+    Vector2 position;
+
+    f32 size    = 0.0f;
+    f32 opacity = 1.0f;
+
+    u32 sprite = 0;
+};
+
+struct Sprite_Instance_Batch {
+    Array<Sprite_Vertex> vertices;
+
+    Array<u64> keys;
+    Array<u32> order;
+    Array<u32> order_swap;
+};
+
+Sprite_Instance_Batch sprite_instance_batch;
+
+void draw_sprite_instances(Sprite* sprites, Array<Sprite_Instance>* instances) {
+    u32 instances_count = instances->count;
+    if (!instances_count) return;
+
+    Sprite_Instance_Batch* batch = &sprite_instance_batch;
+    batch->keys.count = 0;
+
+    for (u32 i = 0; i < instances_count; i++) {
+        Sprite* sprite = &sprites[instances->elements[i].sprite];
+        add(&batch->keys, (u64) (sprite->is_valid ? sprite->texture : 0));
+    }
+
+    radix_sort(&batch->keys, &batch->order, &batch->order_swap);
+
+    if (batch->vertices.capacity < instances_count * 4) allocate(&batch->vertices, instances_count * 4);
+    batch->vertices.count = instances_count * 4;
+
+    for (u32 i = 0; i < instances_count; i++) {
+        Sprite_Instance* instance = &instances->elements[batch->order[i]];
+        Sprite* sprite = &sprites[instance->sprite];
+
+        f32 width = instance->size;
+
+        f32 u0 = 0.0f;
+        f32 v0 = 0.0f;
+        f32 u1 = 1.0f;
+        f32 v1 = 1.0f;
+
+        if (sprite->is_valid) {
+            width = get_sprite_width(sprite, instance->size);
+
+            u0 = sprite->u0;
+            v0 = sprite->v0;
+            u1 = sprite->u1;
+            v1 = sprite->v1;
+        }
+
+        f32 half_width  = width / 2.0f;
+        f32 half_height = instance->size / 2.0f;
+
+        f32 x0 = instance->position.x - half_width;
+        f32 y0 = instance->position.y - half_height;
+        f32 x1 = instance->position.x + half_width;
+        f32 y1 = instance->position.y + half_height;
+
+        Color color = make_color(1.0f, 1.0f, 1.0f, instance->opacity);
+
+        Sprite_Vertex* vertex = &batch->vertices.elements[i * 4];
+
+        vertex[0].x = x0; vertex[0].y = y0; vertex[0].u = u0; vertex[0].v = v1; vertex[0].color = color;
+        vertex[1].x = x1; vertex[1].y = y0; vertex[1].u = u1; vertex[1].v = v1; vertex[1].color = color;
+        vertex[2].x = x1; vertex[2].y = y1; vertex[2].u = u1; vertex[2].v = v0; vertex[2].color = color;
+        vertex[3].x = x0; vertex[3].y = y1; vertex[3].u = u0; vertex[3].v = v0; vertex[3].color = color;
+    }
+
+    set_transform(make_identity_matrix());
+    begin_quads(batch->vertices.elements);
+
+    u32 run_start = 0;
+    while (run_start < instances_count) {
+        u64 texture = batch->keys[batch->order[run_start]];
+
+        u32 run_end = run_start + 1;
+        while (run_end < instances_count && batch->keys[batch->order[run_end]] == texture) {
+            run_end += 1;
+        }
+
+        draw_quads((u32) texture, run_start, run_end - run_start);
+        run_start = run_end;
+    }
+
+    end_quads();
+}
+
 void init_draw() {
     glEnable(GL_TEXTURE_2D);
     glEnable(GL_BLEND);
@@ -1,43 +1,119 @@
 //
-// To add a new entity type, you must do the following:
-//   - Add the entity type to the Entity_Type enum
-//   - Add the case to the to_string for Entity_Type
-//   - Add a pointer to the union on the Entity struct
-//   - Include the entity file in the AS_HEADER block
-//   - Add a bucket and bucket size for the entity
-//   - Add the case in the creation code to call on_create
-//   - Include the entity file again but not as a header
-//   - Add the for_each to call on_update
-//   - Add the case in the collision code to call on_collision
-//   - Add the case in the destruction code to call on_destroy
+// Every entity type is listed once in ENTITY_TYPES, which generates the Entity_Type
+// enum, the pointer on the Entity union, the pool, and the creation, update,
+// collision and destruction dispatch. The last column is the collision mask, the
+// types the entity's on_collision reacts to; pairs that neither side reacts to are
+// never tested. To add a new entity type:
+//   - Add it to ENTITY_TYPES, in the order it should be updated
+//   - Include its file in the AS_HEADER block and again below it
+//   - Define on_create, on_destroy, on_update and on_collision for it
 //
+// An entry is entity_type(NAME, Type, name, pool, bucket_size, collides_with).
+//
+
+#define ENTITY_TYPES(entity_type)                                                                       \
+    entity_type(PLAYER,   Player,   player,   players,   1,  COLLIDES_WITH(ASTEROID))                    \
+    entity_type(LASER,    Laser,    laser,    lasers,    16, COLLIDES_WITH(ASTEROID) |                   \
+                                                             COLLIDES_WITH(PLAYER)   |                   \
+                                                             COLLIDES_WITH(ENEMY))                       \
+    entity_type(ASTEROID, Asteroid, asteroid, asteroids, 16, COLLIDES_WITH_NOTHING)                      \
+    entity_type(ENEMY,    Enemy,    enemy,    enemies,   1,  COLLIDES_WITH(ASTEROID) |                   \
+                                                             COLLIDES_WITH(PLAYER))                      \
+    entity_type(POWERUP,  Powerup,  powerup,  powerups,  4,  COLLIDES_WITH_NOTHING)
+
+#define COLLIDES_WITH(NAME)   (1 << ENTITY_TYPE_##NAME)
+#define COLLIDES_WITH_NOTHING 0
 
-// @todo: Use metaprogramming to automate this process
+#define ENTITY_TYPE_ENUM(NAME, Type, name, pool, bucket_size, collides_with) ENTITY_TYPE_##NAME,
 
 enum Entity_Type {
     ENTITY_TYPE_NONE,
-    ENTITY_TYPE_PLAYER,
-    ENTITY_TYPE_LASER,
-    ENTITY_TYPE_ASTEROID,
-    ENTITY_TYPE_ENEMY,
-    ENTITY_TYPE_POWERUP
+    ENTITY_TYPES(ENTITY_TYPE_ENUM)
+    ENTITY_TYPE_COUNT
 };
 
+#undef ENTITY_TYPE_ENUM
+
+#define ENTITY_TYPE_NAME(NAME, Type, name, pool, bucket_size, collides_with) case ENTITY_TYPE_##NAME: return #Type;
+
 utf8* to_string(Entity_Type entity_type) {
     switch (entity_type) {
-        case ENTITY_TYPE_NONE:     return "None";
-        case ENTITY_TYPE_PLAYER:   return "Player";
-        case ENTITY_TYPE_LASER:    return "Laser";
-        case ENTITY_TYPE_ASTEROID: return "Asteroid";
-        case ENTITY_TYPE_ENEMY:    return "Enemy";
-        case ENTITY_TYPE_POWERUP:  return "Powerup";
+        case ENTITY_TYPE_NONE: return "None";
+        ENTITY_TYPES(ENTITY_TYPE_NAME)
+        case ENTITY_TYPE_COUNT: break;
     }
 
     return "Invalid";
 }
 
+#undef ENTITY_TYPE_NAME
+
+//
+// An entity handle refers to an entity without holding on to its address. The index
+// is the entity's slot in the entities bucket array and the generation is bumped
+// every time the slot is freed, so a handle to a removed entity no longer resolves.
+// A generation of zero is never issued and is used as the null handle.
+//
+
+struct Entity_Handle {
+    u32 index      = 0;
+    u32 generation = 0;
+};
+
+bool operator ==(Entity_Handle a, Entity_Handle b) {
+    return a.index == b.index && a.generation == b.generation;
+}
+
+bool operator !=(Entity_Handle a, Entity_Handle b) {
+    return !(a == b);
+}
+
+//
+// Creating and destroying entities goes through the entity_commands buffer, which
+// is applied once per tick at the end of update_entities. create_entity hands back
+// a fully usable entity straight away, but it stays was_just_created, so it is kept
+// out of collisions and interpolation, until its create command is applied. 
+// destroy_entity only marks the entity and queues a destroy command; on_destroy
+// runs and the entity is removed from its pool when that command is applied. Until
+// then pointers to it stay valid, so nothing walking a pool has it pulled out from
+// under it.
+//
+// The per-type on_update loops run as jobs, see update_pool. While they run other
+// jobs are walking the same pools, so an on_update must not call create_entity or
+// destroy_entity itself. It queues commands on its Update_Job instead, and these
+// are merged into entity_commands on the main thread in job order once the pool is
+// done, so the result doesn't depend on which thread ran what. Each job also draws
+// from its own random stream, seeded from ai_random in job order, for the same
+// reason.
+//
+
+enum Entity_Command_Type {
+    ENTITY_COMMAND_CREATE,
+    ENTITY_COMMAND_DESTROY,
+    ENTITY_COMMAND_FIRE_LASER,
+    ENTITY_COMMAND_PLAY_SOUND
+};
+
+typedef Sound* Get_Sound();
+
+struct Entity_Command {
+    Entity_Command_Type type = ENTITY_COMMAND_CREATE;
+    Entity_Handle entity;
+
+    Laser_Color laser_color = LASER_COLOR_RED;
+    f32         laser_angle = 0.0f;
+
+    // @note: Picked when the command is applied, since picking a sound draws from sound_random
+    Get_Sound* get_sound = null;
+};
+
+struct Update_Job {
+    Random random;
+    Array<Entity_Command> commands;
+};
+
 struct Entity {
-    u32 id = 0;
+    Entity_Handle handle;
     Entity_Type type = ENTITY_TYPE_NONE;
 
     bool was_just_destroyed = false;
@@ -47,11 +123,11 @@ struct Entity {
     Entity* child   = null;
     Entity* sibling = null;
 
-    Matrix4 transform;
+    Transform2 transform;
 
-    Vector2 position;
-    f32 orientation = 0.0f;
-    f32 scale       = 1.0f;
+    // @note: The world transform at the end of the previous tick, for interpolated drawing
+    Transform2 previous_transform;
+    bool       has_previous_transform = false;
 
     Sprite* sprite        = null;
     f32     sprite_size   = 1.0f;
@@ -59,17 +135,17 @@ struct Entity {
     Vector2 sprite_offset;
     bool    is_visible    = false;
 
-    f32  collider_radius = 0.0f;
-    bool has_collider    = false;
+    bool has_collider = false;
+
+    // @note: An entity never collides with its owner, like a laser with its shooter
+    Entity_Handle owner;
 
     union {
         void* derived = null;
 
-        struct Player*   player;
-        struct Laser*    laser;
-        struct Asteroid* asteroid;
-        struct Enemy*    enemy;
-        struct Powerup*  powerup;
+        #define ENTITY_TYPE_POINTER(NAME, Type, name, pool, bucket_size, collides_with) struct Type* name;
+            ENTITY_TYPES(ENTITY_TYPE_POINTER)
+        #undef ENTITY_TYPE_POINTER
     };
 };
 
@@ -81,28 +157,192 @@ struct Entity {
     #include "entities/powerup.cpp"
 #undef AS_HEADER
 
-const u32 ENTITIES_BUCKET_SIZE  = 32;
-const u32 PLAYERS_BUCKET_SIZE   = 1;
-const u32 LASERS_BUCKET_SIZE    = 16;
-const u32 ASTEROIDS_BUCKET_SIZE = 16;
-const u32 ENEMIES_BUCKET_SIZE   = 1;
-const u32 POWERUPS_BUCKET_SIZE  = 4;
+const u32 ENTITIES_BUCKET_SIZE = 32;
+
+Bucket_Array<Entity, ENTITIES_BUCKET_SIZE> entities;
 
-Bucket_Array<Entity,   ENTITIES_BUCKET_SIZE>  entities;
-Bucket_Array<Player,   PLAYERS_BUCKET_SIZE>   players;
-Bucket_Array<Laser,    LASERS_BUCKET_SIZE>    lasers;
-Bucket_Array<Asteroid, ASTEROIDS_BUCKET_SIZE> asteroids;
-Bucket_Array<Enemy,    ENEMIES_BUCKET_SIZE>   enemies;
-Bucket_Array<Powerup,  POWERUPS_BUCKET_SIZE>  powerups;
+#define ENTITY_TYPE_POOL(NAME, Type, name, pool, bucket_size, collides_with) Bucket_Array<Type, bucket_size> pool;
+    ENTITY_TYPES(ENTITY_TYPE_POOL)
+#undef ENTITY_TYPE_POOL
+
+//
+// The transform and physics state of every entity lives in entity_bodies as a
+// structure of arrays indexed by the entity's handle index, so the integration
+// and wrap passes in update_entities walk flat float arrays instead of the
+// entities themselves. Use the get_ and set_ functions below to reach it from
+// an entity. Free slots keep zero velocities, so integrating them is harmless.
+//
+// A body is marked dirty whenever its position, orientation or scale changes, and
+// build_entity_hierarchy only rebuilds the world transforms of dirty entities and
+// their children.
+//
+
+struct Entity_Bodies {
+    Array<f32> position_x;
+    Array<f32> position_y;
+    Array<f32> orientation;
+    Array<f32> scale;
+
+    Array<f32> velocity_x;
+    Array<f32> velocity_y;
+    Array<f32> angular_velocity;
+
+    Array<f32> collider_radius;
+
+    Array<u8> is_dirty;
+};
 
 Entity root_entity;
-u32 next_entity_id;
+Array<u32> entity_generations;
+Array<Entity_Command> entity_commands;
+Entity_Bodies entity_bodies;
+
+// @note: Counts every hierarchy build in a frame, main resets it at the start of each frame
+u32 transforms_rebuilt;
+
 bool should_simulate = true;
 
+void reset_body(u32 index) {
+    entity_bodies.position_x[index]       = 0.0f;
+    entity_bodies.position_y[index]       = 0.0f;
+    entity_bodies.orientation[index]      = 0.0f;
+    entity_bodies.scale[index]            = 1.0f;
+    entity_bodies.velocity_x[index]       = 0.0f;
+    entity_bodies.velocity_y[index]       = 0.0f;
+    entity_bodies.angular_velocity[index] = 0.0f;
+    entity_bodies.collider_radius[index]  = 0.0f;
+    entity_bodies.is_dirty[index]         = true;
+}
+
+void add_body() {
+    add(&entity_bodies.position_x,       0.0f);
+    add(&entity_bodies.position_y,       0.0f);
+    add(&entity_bodies.orientation,      0.0f);
+    add(&entity_bodies.scale,            1.0f);
+    add(&entity_bodies.velocity_x,       0.0f);
+    add(&entity_bodies.velocity_y,       0.0f);
+    add(&entity_bodies.angular_velocity, 0.0f);
+    add(&entity_bodies.collider_radius,  0.0f);
+    add(&entity_bodies.is_dirty,         (u8) true);
+}
+
+Vector2 get_position(Entity* entity) {
+    u32 index = entity->handle.index;
+    return make_vector2(entity_bodies.position_x[index], entity_bodies.position_y[index]);
+}
+
+void set_position(Entity* entity, Vector2 position) {
+    u32 index = entity->handle.index;
+
+    entity_bodies.position_x[index] = position.x;
+    entity_bodies.position_y[index] = position.y;
+    entity_bodies.is_dirty[index]   = true;
+}
+
+f32 get_orientation(Entity* entity) {
+    return entity_bodies.orientation[entity->handle.index];
+}
+
+void set_orientation(Entity* entity, f32 orientation) {
+    entity_bodies.orientation[entity->handle.index] = orientation;
+    entity_bodies.is_dirty[entity->handle.index]    = true;
+}
+
+f32 get_scale(Entity* entity) {
+    return entity_bodies.scale[entity->handle.index];
+}
+
+void set_scale(Entity* entity, f32 scale) {
+    entity_bodies.scale[entity->handle.index]    = scale;
+    entity_bodies.is_dirty[entity->handle.index] = true;
+}
+
+Vector2 get_velocity(Entity* entity) {
+    u32 index = entity->handle.index;
+    return make_vector2(entity_bodies.velocity_x[index], entity_bodies.velocity_y[index]);
+}
+
+void set_velocity(Entity* entity, Vector2 velocity) {
+    u32 index = entity->handle.index;
+
+    entity_bodies.velocity_x[index] = velocity.x;
+    entity_bodies.velocity_y[index] = velocity.y;
+}
+
+f32 get_angular_velocity(Entity* entity) {
+    return entity_bodies.angular_velocity[entity->handle.index];
+}
+
+void set_angular_velocity(Entity* entity, f32 angular_velocity) {
+    entity_bodies.angular_velocity[entity->handle.index] = angular_velocity;
+}
+
+f32 get_collider_radius(Entity* entity) {
+    return entity_bodies.collider_radius[entity->handle.index];
+}
+
+void integrate_bodies(f32 delta) {
+    u32 count = entity_bodies.position_x.count;
+
+    f32* position_x       = entity_bodies.position_x.elements;
+    f32* position_y       = entity_bodies.position_y.elements;
+    f32* orientation      = entity_bodies.orientation.elements;
+    f32* velocity_x       = entity_bodies.velocity_x.elements;
+    f32* velocity_y       = entity_bodies.velocity_y.elements;
+    f32* angular_velocity = entity_bodies.angular_velocity.elements;
+    u8*  is_dirty         = entity_bodies.is_dirty.elements;
+
+    for (u32 i = 0; i < count; i++) {
+        position_x[i]  += velocity_x[i] * delta;
+        position_y[i]  += velocity_y[i] * delta;
+        orientation[i] += angular_velocity[i] * delta;
+
+        is_dirty[i] |= (velocity_x[i] != 0.0f) | (velocity_y[i] != 0.0f) | (angular_velocity[i] != 0.0f);
+    }
+}
+
+void wrap_bodies(f32 left, f32 right, f32 bottom, f32 top) {
+    u32 count = entity_bodies.position_x.count;
+
+    f32* position_x = entity_bodies.position_x.elements;
+    f32* position_y = entity_bodies.position_y.elements;
+    u8*  is_dirty   = entity_bodies.is_dirty.elements;
+
+    for (u32 i = 0; i < count; i++) {
+        f32 x = position_x[i];
+        f32 y = position_y[i];
+
+        f32 wrapped_x = x < left   ? right  : (x > right ? left   : x);
+        f32 wrapped_y = y < bottom ? top    : (y > top   ? bottom : y);
+
+        position_x[i] = wrapped_x;
+        position_y[i] = wrapped_y;
+
+        is_dirty[i] |= (wrapped_x != x) | (wrapped_y != y);
+    }
+}
+
 Entity* create_entity(Entity_Type type, Entity* parent = &root_entity) {
-    Entity* entity = next(&entities);
+    Heap_Tag previous_tag = set_heap_tag(HEAP_TAG_ENTITIES);
+
+    Entity new_entity;
+    Bucket_Locator locator = add(&entities, new_entity);
+
+    u32 index = (locator.array_index * ENTITIES_BUCKET_SIZE) + locator.bucket_index;
+    while (entity_generations.count <= index) {
+        add(&entity_generations, (u32) 1);
+        add_body();
+    }
+
+    set_heap_tag(previous_tag);
+
+    reset_body(index);
+
+    Entity* entity = get(&entities, locator);
+
+    entity->handle.index      = index;
+    entity->handle.generation = entity_generations[index];
 
-    entity->id     = next_entity_id;
     entity->type   = type;
     entity->parent = parent;
 
@@ -118,56 +358,46 @@ Entity* create_entity(Entity_Type type, Entity* parent = &root_entity) {
         entity->parent->child = entity;
     }
 
-    switch (entity->type) {
-        case ENTITY_TYPE_NONE: {
-            break;
+    #define CREATE_ENTITY_TYPE(NAME, Type, name, pool, bucket_size, collides_with) \
+        case ENTITY_TYPE_##NAME: {                                   \
+            entity->name = next(&pool);                              \
+            entity->name->entity = entity;                           \
+                                                                     \
+            on_create(entity->name);                                 \
+            break;                                                   \
         }
-        case ENTITY_TYPE_PLAYER: {
-            entity->player = next(&players);
-            entity->player->entity = entity;
 
-            on_create(entity->player);
+    switch (entity->type) {
+        case ENTITY_TYPE_NONE: {
             break;
         }
-        case ENTITY_TYPE_LASER: {
-            entity->laser = next(&lasers);
-            entity->laser->entity = entity;
+        ENTITY_TYPES(CREATE_ENTITY_TYPE)
+        invalid_default_case();
+    }
 
-            on_create(entity->laser);
-            break;
-        }
-        case ENTITY_TYPE_ASTEROID: {
-            entity->asteroid = next(&asteroids);
-            entity->asteroid->entity = entity;
+    #undef CREATE_ENTITY_TYPE
 
-            on_create(entity->asteroid);
-            break;
-        }
-        case ENTITY_TYPE_ENEMY: {
-            entity->enemy = next(&enemies);
-            entity->enemy->entity = entity;
+    Entity_Command command;
 
-            on_create(entity->enemy);
-            break;
-        }
-        case ENTITY_TYPE_POWERUP: {
-            entity->powerup = next(&powerups);
-            entity->powerup->entity = entity;
+    command.type   = ENTITY_COMMAND_CREATE;
+    command.entity = entity->handle;
 
-            on_create(entity->powerup);
-            break;
-        }
-        invalid_default_case();
-    }
-
-    next_entity_id += 1;
+    add(&entity_commands, command);
 
     return entity;
 }
 
 void destroy_entity(Entity* entity) {
+    if (entity->was_just_destroyed) return;
     entity->was_just_destroyed = true;
 
+    Entity_Command command;
+
+    command.type   = ENTITY_COMMAND_DESTROY;
+    command.entity = entity->handle;
+
+    add(&entity_commands, command);
+
     Entity* child = entity->child;
     while (child) {
         destroy_entity(child);
@@ -181,21 +411,21 @@ void clear_entities() {
     }
 }
 
-Entity* find_entity(u32 id) {
-    Entity* entity = null;
+Entity* get_entity(Entity_Handle handle) {
+    if (!handle.generation) return null;
+    if (handle.index >= entity_generations.count) return null;
+    if (entity_generations[handle.index] != handle.generation) return null;
 
-    for_each (Entity* it, &entities) {
-        if (it->id != id) continue;
-        
-        entity = it;
-        break;
-    }
+    Bucket_Locator locator;
 
-    return entity;
+    locator.array_index  = handle.index / ENTITIES_BUCKET_SIZE;
+    locator.bucket_index = handle.index % ENTITIES_BUCKET_SIZE;
+
+    return get(&entities, locator);
 }
 
 Vector2 get_world_position(Entity* entity) {
-    return make_vector2(entity->transform._41, entity->transform._42);
+    return make_vector2(entity->transform._31, entity->transform._32);
 }
 
 void set_sprite(Entity* entity, Sprite* sprite, f32 size = 1.0f, i32 order = 0, Vector2 offset = make_vector2(0.0f, 0.0f)) {
@@ -207,8 +437,37 @@ void set_sprite(Entity* entity, Sprite* sprite, f32 size = 1.0f, i32 order = 0,
 }
 
 void set_collider(Entity* entity, f32 radius) {
-    entity->collider_radius = radius;
-    entity->has_collider    = true;
+    entity_bodies.collider_radius[entity->handle.index] = radius;
+    entity->has_collider = true;
+}
+
+void queue_destroy(Update_Job* job, Entity* entity) {
+    Entity_Command command;
+
+    command.type   = ENTITY_COMMAND_DESTROY;
+    command.entity = entity->handle;
+
+    add(&job->commands, command);
+}
+
+void queue_fire_laser(Update_Job* job, Entity* shooter, Laser_Color color, f32 angle) {
+    Entity_Command command;
+
+    command.type        = ENTITY_COMMAND_FIRE_LASER;
+    command.entity      = shooter->handle;
+    command.laser_color = color;
+    command.laser_angle = angle;
+
+    add(&job->commands, command);
+}
+
+void queue_play_sound(Update_Job* job, Get_Sound* get_sound) {
+    Entity_Command command;
+
+    command.type      = ENTITY_COMMAND_PLAY_SOUND;
+    command.get_sound = get_sound;
+
+    add(&job->commands, command);
 }
 
 #include "entities/asteroid.cpp"
@@ -217,18 +476,173 @@ void set_collider(Entity* entity, f32 radius) {
 #include "entities/enemy.cpp"
 #include "entities/powerup.cpp"
 
-void build_entity_hierarchy(Entity* entity) {
-    Matrix4 local_transform = make_transform_matrix(entity->position, entity->orientation, entity->scale);
-    if (entity->parent) {
-        entity->transform = entity->parent->transform * local_transform;
+const u32 UPDATE_JOB_ELEMENTS = 64;
+
+Array<Update_Job> update_jobs;
+
+void remove_entity(Entity* entity) {
+    #define REMOVE_ENTITY_TYPE(NAME, Type, name, pool, bucket_size, collides_with) \
+        case ENTITY_TYPE_##NAME: {                                   \
+            on_destroy(entity->name);                                \
+            remove(&pool, entity->name);                             \
+                                                                     \
+            break;                                                   \
+        }
+
+    switch (entity->type) {
+        case ENTITY_TYPE_NONE: {
+            break;
+        }
+        ENTITY_TYPES(REMOVE_ENTITY_TYPE)
+        invalid_default_case();
+    }
+
+    #undef REMOVE_ENTITY_TYPE
+
+    if (entity->parent->child == entity) {
+        entity->parent->child = entity->sibling;
     }
     else {
-        entity->transform = local_transform;
+        Entity* child = entity->parent->child;
+        while (child->sibling != entity) {
+            child = child->sibling;
+        }
+
+        child->sibling = entity->sibling;
+    }
+
+    entity_generations[entity->handle.index] += 1;
+    reset_body(entity->handle.index);
+    remove(&entities, entity);
+}
+
+// @note: Commands queued while applying, like the create of a fired laser, are applied in the same pass
+void apply_entity_commands() {
+    for (u32 i = 0; i < entity_commands.count; i++) {
+        Entity_Command command = entity_commands[i];
+
+        switch (command.type) {
+            case ENTITY_COMMAND_CREATE: {
+                Entity* entity = get_entity(command.entity);
+                if (entity) entity->was_just_created = false;
+
+                break;
+            }
+            case ENTITY_COMMAND_DESTROY: {
+                Entity* entity = get_entity(command.entity);
+                if (entity) remove_entity(entity);
+
+                break;
+            }
+            case ENTITY_COMMAND_FIRE_LASER: {
+                Entity* shooter = get_entity(command.entity);
+                if (!shooter) break;
+
+                Laser* laser = create_entity(ENTITY_TYPE_LASER)->laser;
+                init_laser(laser, command.laser_color, shooter, command.laser_angle);
+
+                break;
+            }
+            case ENTITY_COMMAND_PLAY_SOUND: {
+                play_sound(command.get_sound());
+                break;
+            }
+            invalid_default_case();
+        }
+    }
+
+    entity_commands.count = 0;
+}
+
+// @note: Destroys are marked right away so the entity already sits out this tick's collisions
+void merge_update_job(Update_Job* job) {
+    for_each (Entity_Command* command, &job->commands) {
+        if (command->type == ENTITY_COMMAND_DESTROY) {
+            Entity* entity = get_entity(command->entity);
+            if (entity) destroy_entity(entity);
+        }
+        else {
+            add(&entity_commands, *command);
+        }
+    }
+
+    job->commands.count = 0;
+}
+
+template<typename type, u32 size>
+struct Pool_Update {
+    Bucket_Array<type, size>* pool = null;
+    u32 buckets_per_job = 0;
+};
+
+template<typename type, u32 size>
+void update_pool_job(void* data, u32 job_index) {
+    Pool_Update<type, size>* pool_update = (Pool_Update<type, size>*) data;
+    Update_Job* job = &update_jobs[job_index];
+
+    u32 first_bucket = job_index * pool_update->buckets_per_job;
+    u32 last_bucket  = first_bucket + pool_update->buckets_per_job;
+
+    if (last_bucket > pool_update->pool->buckets.count) last_bucket = pool_update->pool->buckets.count;
+
+    for (u32 i = first_bucket; i < last_bucket; i++) {
+        Bucket<type, size>* bucket = pool_update->pool->buckets[i];
+        if (!bucket->occupied) continue;
+
+        for (u32 j = 0; j < size; j++) {
+            if (is_occupied(bucket, j)) on_update(&bucket->slots[j].element, job);
+        }
+    }
+}
+
+// @note: Jobs cover whole buckets, so the split only depends on the pool and not on the thread count
+template<typename type, u32 size>
+void update_pool(Bucket_Array<type, size>* pool) {
+    if (!pool->count) return;
+
+    Pool_Update<type, size> pool_update;
+
+    pool_update.pool            = pool;
+    pool_update.buckets_per_job = size < UPDATE_JOB_ELEMENTS ? UPDATE_JOB_ELEMENTS / size : 1;
+
+    u32 job_count = (pool->buckets.count + pool_update.buckets_per_job - 1) / pool_update.buckets_per_job;
+
+    Heap_Tag previous_tag = set_heap_tag(HEAP_TAG_ENTITIES);
+    while (update_jobs.count < job_count) next(&update_jobs);
+    set_heap_tag(previous_tag);
+
+    for (u32 i = 0; i < job_count; i++) {
+        update_jobs[i].random = make_random(get_random_u32(&ai_random), i);
+    }
+
+    run_jobs(update_pool_job<type, size>, &pool_update, job_count);
+
+    for (u32 i = 0; i < job_count; i++) {
+        merge_update_job(&update_jobs[i]);
+    }
+}
+
+void build_entity_hierarchy(Entity* entity, bool parent_changed = false) {
+    bool changed = parent_changed;
+
+    // @note: The root entity is not in the entities bucket array, so it has no body
+    // and its transform is always the identity
+    if (entity != &root_entity) {
+        u32 index = entity->handle.index;
+        changed |= entity_bodies.is_dirty[index] != 0;
+
+        if (changed) {
+            Transform2 local_transform = make_transform2(get_position(entity), get_orientation(entity), get_scale(entity));
+            entity->transform = entity->parent->transform * local_transform;
+
+            entity_bodies.is_dirty[index] = false;
+            transforms_rebuilt += 1;
+        }
     }
 
     Entity* child = entity->child;
     while (child) {
-        build_entity_hierarchy(child);
+        build_entity_hierarchy(child, changed);
         child = child->sibling;
     }
 }
@@ -246,351 +660,389 @@ void draw_entity_hierarchy(Entity* entity) {
     end_layout();
 }
 
-Array<Entity*> sort_visible_entities(Array<Entity*> visible_entities) {
-    visible_entities.allocator = &temp_allocator;
+//
+// Collisions are dispatched through a table indexed by the types of both entities.
+// Each entry is a handle_collision instantiation, so the call to the type's
+// on_collision is inlined into it. An entry is only filled in when the type's
+// collision mask has the other type, and a pair with no entry either way is skipped
+// before the circles are tested. Each pair is only visited once, and dispatched to
+// whichever of the two reacts to it.
+//
 
-    if (visible_entities.count < 2) return visible_entities;
-    u32 middle = visible_entities.count / 2;
-    
-    Array<Entity*> left  = copy(&visible_entities, 0, middle);
-    Array<Entity*> right = copy(&visible_entities, middle, visible_entities.count);
+typedef void Collision_Handler(Entity* us, Entity* them);
 
-    left  = sort_visible_entities(left);
-    right = sort_visible_entities(right);
+Collision_Handler* collision_handlers[ENTITY_TYPE_COUNT][ENTITY_TYPE_COUNT];
 
-    Array<Entity*> sorted;
-    sorted.allocator = &temp_allocator;
+// @note: The types that are in a collision pair at all, only these go in the grid
+u32 colliding_types;
 
-    while (left.count && right.count) {
-        if (left[0]->sprite_order <= right[0]->sprite_order) {
-            add(&sorted, left[0]);
-            remove(&left, 0);
-        }
-        else {
-            add(&sorted, right[0]);
-            remove(&right, 0);
-        }
-    }
+template<typename type>
+void handle_collision(Entity* us, Entity* them) {
+    on_collision((type*) us->derived, them);
+}
 
-    while (left.count) {
-        add(&sorted, left[0]);
-        remove(&left, 0);
-    }
+void init_entities() {
+    for (u32 i = 0; i < ENTITY_TYPE_COUNT; i++) {
+        #define COLLISION_HANDLER(NAME, Type, name, pool, bucket_size, collides_with)   \
+            if ((collides_with) & (1 << i)) {                                           \
+                collision_handlers[ENTITY_TYPE_##NAME][i] = handle_collision<Type>;     \
+                colliding_types |= (1 << ENTITY_TYPE_##NAME) | (1 << i);                \
+            }
 
-    while (right.count) {
-        add(&sorted, right[0]);
-        remove(&right, 0);
-    }
+        ENTITY_TYPES(COLLISION_HANDLER)
 
-    return sorted;
+        #undef COLLISION_HANDLER
+    }
 }
 
-void update_entities() {
-    for_each (Player* player, &players)       on_update(player);
-    for_each (Laser* laser, &lasers)          on_update(laser);
-    for_each (Asteroid* asteroid, &asteroids) on_update(asteroid);
-    for_each (Enemy* enemy, &enemies)         on_update(enemy);
-    for_each (Powerup* powerup, &powerups)    on_update(powerup);
+struct Collider {
+    Entity* entity = null;
 
-    for_each (Entity* entity, &entities) {
-        if (entity->position.x < world_left)   entity->position.x = world_right;
-        if (entity->position.x > world_right)  entity->position.x = world_left;
-        if (entity->position.y < world_bottom) entity->position.y = world_top;
-        if (entity->position.y > world_top)    entity->position.y = world_bottom;
-    }
+    Vector2 position;
+    f32 radius = 0.0f;
 
-    build_entity_hierarchy(&root_entity);
+    i32 cell_x = 0;
+    i32 cell_y = 0;
+};
 
-    for_each (Entity* us, &entities) {
-        if (us->was_just_created)   continue;
-        if (us->was_just_destroyed) continue;
-        if (!us->has_collider)      continue;
+//
+// The collision grid is a uniform grid laid over the world bounds and rebuilt
+// every frame. Cells are at least as wide as the largest collider, so any two
+// colliders that could touch are always in the same or a neighboring cell. The
+// colliders are bucketed by cell with a counting sort, so a cell's colliders are
+// cell_colliders[cell_starts[cell]] up to cell_colliders[cell_starts[cell + 1]].
+//
 
-        for_each (Entity* them, &entities) {
-            if (us == them) continue;
+struct Collision_Grid {
+    u32 cells_x = 0;
+    u32 cells_y = 0;
 
-            if (them->was_just_created)   continue;
-            if (them->was_just_destroyed) continue;
-            if (!them->has_collider)      continue;
+    f32 cell_width  = 0.0f;
+    f32 cell_height = 0.0f;
 
-            Vector2 us_position   = get_world_position(us);
-            Vector2 them_position = get_world_position(them);
+    Array<Collider>  colliders;
+    Array<u32>       cell_starts;
+    Array<Collider*> cell_colliders;
+};
 
-            bool did_collide = false;
+//
+// The world wraps around, so every entity also exists one world width and height
+// over in each direction. Collisions use the nearest of those images, and an entity
+// close enough to an edge to show on the other side is also drawn at its ghosts,
+// the images that overlap the world.
+//
 
-            Circle circle_us   = make_circle(us_position,   us->collider_radius);
-            Circle circle_them = make_circle(them_position, them->collider_radius);
+const u32 MAX_GHOSTS = 3;
 
-            if (intersects(circle_us, circle_them)) {
-                did_collide = true;
-            }
-            
-            // if (position.x - world_left <= bounds) {
-            //     f32 mirrored_x = world_right + (position.x - world_left);
+struct Ghosts {
+    u32 count = 0;
+    Vector2 offsets[MAX_GHOSTS];
+};
 
-            //     Matrix4 new_transform = transform;
-            //     new_transform._41 = mirrored_x;
+// @note: The offset from a to the nearest image of b
+Vector2 get_wrapped_delta(Vector2 a, Vector2 b) {
+    Vector2 delta = b - a;
 
-            //     set_transform(new_transform);
-            //     draw_sprite(entity->sprite, entity->sprite_size);
-            // }
+    if (delta.x >  world_width  / 2.0f) delta.x -= world_width;
+    if (delta.x < -world_width  / 2.0f) delta.x += world_width;
+    if (delta.y >  world_height / 2.0f) delta.y -= world_height;
+    if (delta.y < -world_height / 2.0f) delta.y += world_height;
 
-            // if (world_right - position.x <= bounds) {
-            //     f32 mirrored_x = world_left - (world_right - position.x);
+    return delta;
+}
 
-            //     Matrix4 new_transform = transform;
-            //     new_transform._41 = mirrored_x;
+Ghosts get_ghosts(Vector2 position, f32 extent) {
+    f32 offset_x = 0.0f;
+    f32 offset_y = 0.0f;
 
-            //     set_transform(new_transform);
-            //     draw_sprite(entity->sprite, entity->sprite_size);
-            // }
+    if      (position.x - world_left   <= extent) offset_x =  world_width;
+    else if (world_right - position.x  <= extent) offset_x = -world_width;
 
-            // if (position.y - world_bottom <= bounds) {
-            //     f32 mirrored_y = world_top + (position.y - world_bottom);
+    if      (position.y - world_bottom <= extent) offset_y =  world_height;
+    else if (world_top - position.y    <= extent) offset_y = -world_height;
 
-            //     Matrix4 new_transform = transform;
-            //     new_transform._42 = mirrored_y;
+    Ghosts ghosts;
 
-            //     set_transform(new_transform);
-            //     draw_sprite(entity->sprite, entity->sprite_size);
-            // }
+    if (offset_x != 0.0f) ghosts.offsets[ghosts.count++] = make_vector2(offset_x, 0.0f);
+    if (offset_y != 0.0f) ghosts.offsets[ghosts.count++] = make_vector2(0.0f, offset_y);
 
-            // if (world_top - position.y <= bounds) {
-            //     f32 mirrored_y = world_bottom - (world_top - position.y);
+    if (offset_x != 0.0f && offset_y != 0.0f) {
+        ghosts.offsets[ghosts.count++] = make_vector2(offset_x, offset_y);
+    }
 
-            //     Matrix4 new_transform = transform;
-            //     new_transform._42 = mirrored_y;
+    return ghosts;
+}
 
-            //     set_transform(new_transform);
-            //     draw_sprite(entity->sprite, entity->sprite_size);
-            // }
+i32 wrap_cell(i32 cell, u32 cells) {
+    i32 result = cell % (i32) cells;
+    if (result < 0) result += cells;
 
-            if (did_collide) {
-                switch (us->type) {
-                    case ENTITY_TYPE_NONE: {
-                        break;
-                    }
-                    case ENTITY_TYPE_PLAYER: {
-                        on_collision(us->player, them);
-                        break;
-                    }
-                    case ENTITY_TYPE_LASER: {
-                        on_collision(us->laser, them);
-                        break;
-                    }
-                    case ENTITY_TYPE_ASTEROID: {
-                        on_collision(us->asteroid, them);
-                        break;
-                    }
-                    case ENTITY_TYPE_ENEMY: {
-                        on_collision(us->enemy, them);
-                        break;
-                    }
-                    case ENTITY_TYPE_POWERUP: {
-                        on_collision(us->powerup, them);
-                        break;
-                    }
-                    invalid_default_case();
-                }
-            }
+    return result;
+}
+
+// @note: The world wraps around, so the neighbors of an edge cell include the cells
+// on the opposite edge. With less than three cells the wrapped neighbors overlap,
+// so only the distinct ones are returned.
+u32 get_neighbor_cells(i32 cell, u32 cells, i32* neighbors) {
+    if (cells < 3) {
+        for (u32 i = 0; i < cells; i++) {
+            neighbors[i] = i;
         }
+
+        return cells;
     }
 
-    for_each (Entity* entity, &entities) {
-        if (!entity->was_just_destroyed) continue;
+    neighbors[0] = wrap_cell(cell - 1, cells);
+    neighbors[1] = cell;
+    neighbors[2] = wrap_cell(cell + 1, cells);
 
-        switch (entity->type) {
-            case ENTITY_TYPE_NONE: {
-                break;
-            }
-            case ENTITY_TYPE_PLAYER: {
-                on_destroy(entity->player);
-                remove(&players, entity->player);
+    return 3;
+}
 
-                break;
-            }
-            case ENTITY_TYPE_LASER: {
-                on_destroy(entity->laser);
-                remove(&lasers, entity->laser);
+Collision_Grid build_collision_grid() {
+    Collision_Grid grid;
 
-                break;
-            }
-            case ENTITY_TYPE_ASTEROID: {
-                on_destroy(entity->asteroid);
-                remove(&asteroids, entity->asteroid);
+    grid.colliders.allocator      = &temp_allocator;
+    grid.cell_starts.allocator    = &temp_allocator;
+    grid.cell_colliders.allocator = &temp_allocator;
 
-                break;
-            }
-            case ENTITY_TYPE_ENEMY: {
-                on_destroy(entity->enemy);
-                remove(&enemies, entity->enemy);
+    f32 max_radius = 0.0f;
 
-                break;
-            }
-            case ENTITY_TYPE_POWERUP: {
-                on_destroy(entity->powerup);
-                remove(&powerups, entity->powerup);
+    for_each (Entity* entity, &entities) {
+        if (entity->was_just_created)   continue;
+        if (entity->was_just_destroyed) continue;
+        if (!entity->has_collider)      continue;
 
-                break;
-            }
-            invalid_default_case();
-        }
+        if (!(colliding_types & (1 << entity->type))) continue;
 
-        if (entity->parent->child == entity) {
-            entity->parent->child = entity->sibling;
-        }
-        else {
-            Entity* child = entity->parent->child;
-            while (child->sibling != entity) {
-                child = child->sibling;
-            }
+        Collider* collider = next(&grid.colliders);
+
+        collider->entity   = entity;
+        collider->position = get_world_position(entity);
+        collider->radius   = get_collider_radius(entity);
 
-            child->sibling = entity->sibling;
+        if (collider->radius > max_radius) {
+            max_radius = collider->radius;
         }
+    }
 
-        remove(&entities, entity);
+    f32 min_cell_size = 2.0f * max_radius;
+
+    grid.cells_x = 1;
+    grid.cells_y = 1;
+
+    if (min_cell_size > 0.0f) {
+        if (world_width  > min_cell_size) grid.cells_x = (u32) (world_width  / min_cell_size);
+        if (world_height > min_cell_size) grid.cells_y = (u32) (world_height / min_cell_size);
     }
 
-    for_each (Entity* entity, &entities) {
-        if (!entity->was_just_created) continue;
-        entity->was_just_created = false;
+    grid.cell_width  = world_width  / grid.cells_x;
+    grid.cell_height = world_height / grid.cells_y;
+
+    u32 cells_count = grid.cells_x * grid.cells_y;
+    allocate(&grid.cell_starts, cells_count + 1);
+
+    for (u32 i = 0; i < cells_count + 1; i++) {
+        add(&grid.cell_starts, (u32) 0);
     }
 
-    build_entity_hierarchy(&root_entity);
-}
+    for_each (Collider* collider, &grid.colliders) {
+        collider->cell_x = wrap_cell((i32) floorf((collider->position.x - world_left)   / grid.cell_width),  grid.cells_x);
+        collider->cell_y = wrap_cell((i32) floorf((collider->position.y - world_bottom) / grid.cell_height), grid.cells_y);
 
-void draw_entities() {
-    Array<Entity*> visible_entities;
-    visible_entities.allocator = &temp_allocator;
+        u32 cell = (collider->cell_y * grid.cells_x) + collider->cell_x;
+        grid.cell_starts[cell + 1] += 1;
+    }
+
+    for (u32 i = 0; i < cells_count; i++) {
+        grid.cell_starts[i + 1] += grid.cell_starts[i];
+    }
+
+    allocate(&grid.cell_colliders, grid.colliders.count);
+
+    for (u32 i = 0; i < grid.colliders.count; i++) {
+        add(&grid.cell_colliders, (Collider*) null);
+    }
 
+    Array<u32> cell_cursors = copy(&grid.cell_starts);
+
+    for_each (Collider* collider, &grid.colliders) {
+        u32 cell = (collider->cell_y * grid.cells_x) + collider->cell_x;
+
+        grid.cell_colliders[cell_cursors[cell]] = collider;
+        cell_cursors[cell] += 1;
+    }
+
+    return grid;
+}
+
+void update_entities() {
+    // @note: Entities created since the last tick haven't had their transform built yet
     for_each (Entity* entity, &entities) {
-        if (!entity->sprite)     continue;
-        if (!entity->is_visible) continue;
+        if (entity->was_just_created) continue;
 
-        add(&visible_entities, entity);
+        entity->previous_transform     = entity->transform;
+        entity->has_previous_transform = true;
     }
-    
-    Array<Entity*> sorted_entities = sort_visible_entities(visible_entities);
 
-    for_each (Entity** it, &sorted_entities) {
-        Entity* entity = *it;
+    integrate_bodies(timers.tick_delta);
 
-        Matrix4 transform = entity->transform * make_transform_matrix(entity->sprite_offset);
-        Vector2 position  = make_vector2(transform._41, transform._42);
+    #define UPDATE_ENTITY_TYPE(NAME, Type, name, pool, bucket_size, collides_with) update_pool(&pool);
+        ENTITY_TYPES(UPDATE_ENTITY_TYPE)
+    #undef UPDATE_ENTITY_TYPE
 
-        f32 width  = entity->sprite->aspect * entity->sprite_size;
-        f32 height = entity->sprite_size;
+    wrap_bodies(world_left, world_right, world_bottom, world_top);
 
-        f32 bounds = width > height ? width : height;
+    build_entity_hierarchy(&root_entity);
 
-        if (position.x - world_left <= bounds) {
-            f32 mirrored_x = world_right + (position.x - world_left);
+    Collision_Grid grid = build_collision_grid();
 
-            Matrix4 new_transform = transform;
-            new_transform._41 = mirrored_x;
+    for_each (Collider* us, &grid.colliders) {
+        if (us->entity->was_just_destroyed) continue;
 
-            set_transform(new_transform);
-            draw_sprite(entity->sprite, entity->sprite_size);
+        i32 cells_x[3];
+        i32 cells_y[3];
 
-            #if DEBUG
-                if (entity->has_collider) {
-                    new_transform = entity->transform;
-                    new_transform._41 = mirrored_x;
-
-                    set_transform(new_transform);
-                    
-                    draw_circle(
-                        make_circle(make_vector2(0.0f, 0.0f), entity->collider_radius), 
-                        make_color(0.0f, 1.0f, 0.0f), 
-                        false);
-                }
-            #endif
-        }
+        u32 cells_x_count = get_neighbor_cells(us->cell_x, grid.cells_x, cells_x);
+        u32 cells_y_count = get_neighbor_cells(us->cell_y, grid.cells_y, cells_y);
 
-        if (world_right - position.x <= bounds) {
-            f32 mirrored_x = world_left - (world_right - position.x);
+        for (u32 i = 0; i < cells_y_count; i++) {
+            for (u32 j = 0; j < cells_x_count; j++) {
+                u32 cell = (cells_y[i] * grid.cells_x) + cells_x[j];
 
-            Matrix4 new_transform = transform;
-            new_transform._41 = mirrored_x;
+                for (u32 k = grid.cell_starts[cell]; k < grid.cell_starts[cell + 1]; k++) {
+                    Collider* them = grid.cell_colliders[k];
+                    if (them <= us) continue;
 
-            set_transform(new_transform);
-            draw_sprite(entity->sprite, entity->sprite_size);
+                    if (us->entity->was_just_destroyed)   break;
+                    if (them->entity->was_just_destroyed) continue;
 
-            #if DEBUG
-                if (entity->has_collider) {
-                    new_transform = entity->transform;
-                    new_transform._41 = mirrored_x;
-
-                    set_transform(new_transform);
-                    
-                    draw_circle(
-                        make_circle(make_vector2(0.0f, 0.0f), entity->collider_radius), 
-                        make_color(0.0f, 1.0f, 0.0f), 
-                        false);
-                }
-            #endif
-        }
+                    Collision_Handler* us_handler   = collision_handlers[us->entity->type][them->entity->type];
+                    Collision_Handler* them_handler = collision_handlers[them->entity->type][us->entity->type];
 
-        if (position.y - world_bottom <= bounds) {
-            f32 mirrored_y = world_top + (position.y - world_bottom);
+                    if (!us_handler && !them_handler) continue;
 
-            Matrix4 new_transform = transform;
-            new_transform._42 = mirrored_y;
+                    if (us->entity->owner   == them->entity->handle) continue;
+                    if (them->entity->owner == us->entity->handle)   continue;
 
-            set_transform(new_transform);
-            draw_sprite(entity->sprite, entity->sprite_size);
+                    f32 radii = us->radius + them->radius;
+                    if (get_length_squared(get_wrapped_delta(us->position, them->position)) > square(radii)) continue;
 
-            #if DEBUG
-                if (entity->has_collider) {
-                    new_transform = entity->transform;
-                    new_transform._42 = mirrored_y;
-
-                    set_transform(new_transform);
-                    
-                    draw_circle(
-                        make_circle(make_vector2(0.0f, 0.0f), entity->collider_radius), 
-                        make_color(0.0f, 1.0f, 0.0f), 
-                        false);
+                    if (us_handler) {
+                        us_handler(us->entity, them->entity);
+                    }
+
+                    if (them_handler && !us->entity->was_just_destroyed && !them->entity->was_just_destroyed) {
+                        them_handler(them->entity, us->entity);
+                    }
                 }
-            #endif
+            }
         }
+    }
+
+    apply_entity_commands();
+
+    build_entity_hierarchy(&root_entity);
+}
+
+#if DEBUG
+    struct Debug_Collider {
+        Transform2 transform;
+        f32 radius = 0.0f;
+    };
+
+    Debug_Collider make_debug_collider(Transform2 transform, f32 radius) {
+        Debug_Collider debug_collider;
+
+        debug_collider.transform = transform;
+        debug_collider.radius    = radius;
 
-        if (world_top - position.y <= bounds) {
-            f32 mirrored_y = world_bottom - (world_top - position.y);
+        return debug_collider;
+    }
+#endif
 
-            Matrix4 new_transform = transform;
-            new_transform._42 = mirrored_y;
+//
+// Entities are drawn between their last two ticks by tick_interpolation so motion
+// stays smooth when the frame rate and the tick rate differ. An entity that moved
+// more than half the world in one tick has wrapped around, and is drawn where it
+// is instead of sweeping across the screen.
+//
 
-            set_transform(new_transform);
-            draw_sprite(entity->sprite, entity->sprite_size);
+Transform2 get_draw_transform(Entity* entity) {
+    if (!entity->has_previous_transform) return entity->transform;
+
+    Transform2 from = entity->previous_transform;
+    Transform2 to   = entity->transform;
+
+    if (absolute(to._31 - from._31) > world_width  / 2.0f) return to;
+    if (absolute(to._32 - from._32) > world_height / 2.0f) return to;
+
+    return lerp(from, timers.tick_interpolation, to);
+}
+
+void draw_entities() {
+    #if DEBUG
+        Array<Debug_Collider> debug_colliders;
+        debug_colliders.allocator = &temp_allocator;
+    #endif
+
+    for_each (Entity* entity, &entities) {
+        if (!entity->sprite)     continue;
+        if (!entity->is_visible) continue;
+
+        Transform2 draw_transform = get_draw_transform(entity);
+
+        Transform2 transform = draw_transform * make_transform2(entity->sprite_offset);
+        Vector2    position  = make_vector2(transform._31, transform._32);
+
+        f32 width  = entity->sprite->aspect * entity->sprite_size;
+        f32 height = entity->sprite_size;
+
+        f32 bounds = width > height ? width : height;
+
+        Ghosts ghosts = get_ghosts(position, bounds);
+
+        for (u32 i = 0; i < ghosts.count; i++) {
+            Vector2 offset = ghosts.offsets[i];
+
+            Transform2 ghost_transform = transform;
+
+            ghost_transform._31 += offset.x;
+            ghost_transform._32 += offset.y;
+
+            batch_sprite(entity->sprite, ghost_transform, entity->sprite_size, 1.0f, true, entity->sprite_order);
 
             #if DEBUG
                 if (entity->has_collider) {
-                    new_transform = entity->transform;
-                    new_transform._42 = mirrored_y;
+                    Transform2 ghost_collider_transform = draw_transform;
 
-                    set_transform(new_transform);
+                    ghost_collider_transform._31 += offset.x;
+                    ghost_collider_transform._32 += offset.y;
 
-                    draw_circle(
-                        make_circle(make_vector2(0.0f, 0.0f), entity->collider_radius), 
-                        make_color(0.0f, 1.0f, 0.0f), 
-                        false);
+                    add(&debug_colliders, make_debug_collider(ghost_collider_transform, get_collider_radius(entity)));
                 }
             #endif
         }
 
-        set_transform(transform);
-        draw_sprite(entity->sprite, entity->sprite_size);
+        batch_sprite(entity->sprite, transform, entity->sprite_size, 1.0f, true, entity->sprite_order);
 
         #if DEBUG
             if (entity->has_collider) {
-                set_transform(entity->transform);
-                
-                draw_circle(
-                    make_circle(make_vector2(0.0f, 0.0f), entity->collider_radius), 
-                    make_color(0.0f, 1.0f, 0.0f), 
-                    false);
+                add(&debug_colliders, make_debug_collider(draw_transform, get_collider_radius(entity)));
             }
         #endif
     }
+
+    flush_sprite_batch();
+
+    #if DEBUG
+        for_each (Debug_Collider* debug_collider, &debug_colliders) {
+            set_transform(debug_collider->transform);
+
+            draw_circle(
+                make_circle(make_vector2(0.0f, 0.0f), debug_collider->radius), 
+                make_color(0.0f, 1.0f, 0.0f), 
+                false);
+        }
+    #endif
 }
\ No newline at end of file
@@ -5,14 +5,11 @@ struct Asteroid {
 
     Asteroid_Size size;
     u32 score = 0;
-
-    Vector2 velocity;
-    f32 rotation_speed = 0.0f;
 };
 
 void on_create(Asteroid* asteroid);
 void on_destroy(Asteroid* asteroid);
-void on_update(Asteroid* asteroid);
+void on_update(Asteroid* asteroid, Update_Job* job);
 void on_collision(Asteroid* asteroid, Entity* them);
 
 #else
@@ -27,8 +24,8 @@ void set_asteroid_size(Asteroid* asteroid, Asteroid_Size size) {
 
             asteroid->score = 100;
 
-            asteroid->velocity       = make_vector2(get_random_between(-3.0f, 3.0f), get_random_between(-3.0f, 3.0f));
-            asteroid->rotation_speed = get_random_between(-300.0f, 300.0f);
+            set_velocity(asteroid->entity, make_vector2(get_random_between(&spawn_random, -3.0f, 3.0f), get_random_between(&spawn_random, -3.0f, 3.0f)));
+            set_angular_velocity(asteroid->entity, get_random_between(&spawn_random, -300.0f, 300.0f));
                 
             break;
         }
@@ -38,8 +35,8 @@ void set_asteroid_size(Asteroid* asteroid, Asteroid_Size size) {
             
             asteroid->score = 50;
 
-            asteroid->velocity       = make_vector2(get_random_between(-1.5f, 1.5f), get_random_between(-1.5f, 1.5f));
-            asteroid->rotation_speed = get_random_between(-150.0f, 150.0f);
+            set_velocity(asteroid->entity, make_vector2(get_random_between(&spawn_random, -1.5f, 1.5f), get_random_between(&spawn_random, -1.5f, 1.5f)));
+            set_angular_velocity(asteroid->entity, get_random_between(&spawn_random, -150.0f, 150.0f));
 
             break;
         }
@@ -49,8 +46,8 @@ void set_asteroid_size(Asteroid* asteroid, Asteroid_Size size) {
             
             asteroid->score = 20;
 
-            asteroid->velocity       = make_vector2(get_random_between(-0.5f, 0.5f), get_random_between(-0.5f, 0.5f));
-            asteroid->rotation_speed = get_random_between(-50.0f, 50.0f);
+            set_velocity(asteroid->entity, make_vector2(get_random_between(&spawn_random, -0.5f, 0.5f), get_random_between(&spawn_random, -0.5f, 0.5f)));
+            set_angular_velocity(asteroid->entity, get_random_between(&spawn_random, -50.0f, 50.0f));
 
             break;
         }
@@ -59,29 +56,32 @@ void set_asteroid_size(Asteroid* asteroid, Asteroid_Size size) {
 }
 
 void spawn_children(Asteroid* asteroid) {
+    Vector2 position = get_position(asteroid->entity);
+    Vector2 velocity = get_velocity(asteroid->entity);
+
     for (u32 i = 0; i < 2; i++) {
         switch (asteroid->size) {
             case ASTEROID_SIZE_SMALL: {
-                spawn_particles(asteroid->entity->position, asteroid->velocity, 0.25f);
+                spawn_particles(position, velocity, 0.25f);
                 break;
             }
             case ASTEROID_SIZE_MEDIUM: {
                 Asteroid* child_asteroid = create_entity(ENTITY_TYPE_ASTEROID)->asteroid;
 
-                child_asteroid->entity->position = asteroid->entity->position;
+                set_position(child_asteroid->entity, position);
                 set_asteroid_size(child_asteroid, ASTEROID_SIZE_SMALL);
 
-                spawn_particles(asteroid->entity->position, asteroid->velocity, 0.5f);
+                spawn_particles(position, velocity, 0.5f);
 
                 break;
             }
             case ASTEROID_SIZE_LARGE: {
                 Asteroid* child_asteroid = create_entity(ENTITY_TYPE_ASTEROID)->asteroid;
 
-                child_asteroid->entity->position = asteroid->entity->position;
+                set_position(child_asteroid->entity, position);
                 set_asteroid_size(child_asteroid, ASTEROID_SIZE_MEDIUM);
 
-                spawn_particles(asteroid->entity->position, asteroid->velocity, 0.75f);
+                spawn_particles(position, velocity, 0.75f);
 
                 break;
             }
@@ -93,16 +93,15 @@ void spawn_children(Asteroid* asteroid) {
 }
 
 void on_create(Asteroid* asteroid) {
-    asteroid->entity->orientation = get_random_between(-360.0f, 360.0f);
+    set_orientation(asteroid->entity, get_random_between(&spawn_random, -360.0f, 360.0f));
 }
 
 void on_destroy(Asteroid* asteroid) {
     
 }
 
-void on_update(Asteroid* asteroid) {
-    asteroid->entity->position    += asteroid->velocity * timers.delta;
-    asteroid->entity->orientation += asteroid->rotation_speed * timers.delta;
+void on_update(Asteroid* asteroid, Update_Job* job) {
+    // @note: Asteroid motion lives in integrate_bodies.
 }
 
 void on_collision(Asteroid* asteroid, Entity* them) {
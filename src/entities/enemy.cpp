@@ -14,13 +14,11 @@ struct Enemy {
 
     f32 fire_rate = 0.0f;
     f32 next_fire = 0.0f;
-
-    Vector2 velocity;
 };
 
 void on_create(Enemy* enemy);
 void on_destroy(Enemy* enemy);
-void on_update(Enemy* enemy);
+void on_update(Enemy* enemy, Update_Job* job);
 void on_collision(Enemy* enemy, Entity* them);
 
 void kill_enemy();
@@ -59,8 +57,10 @@ void set_enemy_mode(Enemy* enemy, Enemy_Mode enemy_mode) {
 }
 
 void on_create(Enemy* enemy) {
-    enemy->entity->position = make_vector2(world_left, get_random_between(world_bottom, world_top));
-    enemy->velocity = make_vector2(get_random_chance(2) ? -3.0f : 3.0f, 0.0f);
+    set_position(enemy->entity, make_vector2(world_left, get_random_between(&spawn_random, world_bottom, world_top)));
+
+    set_velocity(enemy->entity, make_vector2(get_random_chance(&spawn_random, 2) ? -3.0f : 3.0f, 0.0f));
+    set_angular_velocity(enemy->entity, -100.0f);
 
     play_sound(&sound_spawn);
 }
@@ -69,10 +69,7 @@ void on_destroy(Enemy* enemy) {
     play_sound(get_kill_sound());
 }
 
-void on_update(Enemy* enemy) {
-    enemy->entity->position    += enemy->velocity * timers.delta;
-    enemy->entity->orientation -= 100.0f * timers.delta;
-
+void on_update(Enemy* enemy, Update_Job* job) {
     Player* player = null;
     for_each (Player* p, &players) {
         player = p;
@@ -80,29 +77,27 @@ void on_update(Enemy* enemy) {
     }
 
     if (player) {
-        if ((enemy->next_fire -= timers.delta) <= 0.0f) {
+        if ((enemy->next_fire -= timers.tick_delta) <= 0.0f) {
             enemy->next_fire = enemy->fire_rate;
 
             f32 fire_angle = 0.0f;
             switch (enemy->mode) {
                 case ENEMY_MODE_EASY: {
-                    fire_angle = get_random_between(0.0f, 360.0f);
+                    fire_angle = get_random_between(&job->random, 0.0f, 360.0f);
                     break;
                 }
                 case ENEMY_MODE_HARD: {
                     fire_angle = get_angle(
-                        normalize(player->entity->position - enemy->entity->position)) + 
-                        get_random_between(-15.0f, 15.0f);
+                        normalize(get_position(player->entity) - get_position(enemy->entity))) + 
+                        get_random_between(&job->random, -15.0f, 15.0f);
 
                     break;
                 }
                 invalid_default_case();
             }
 
-            Laser* laser = create_entity(ENTITY_TYPE_LASER)->laser;
-            init_laser(laser, LASER_COLOR_RED, enemy->entity, fire_angle);
-            
-            play_sound(get_enemy_fire_sound());
+            queue_fire_laser(job, enemy->entity, LASER_COLOR_RED, fire_angle);
+            queue_play_sound(job, get_enemy_fire_sound);
         }
     }
     else {
@@ -2,24 +2,23 @@
 
 struct Laser {
     Entity* entity = null;
-
-    u32 shooter_id = 0;
     f32 lifetime = 1.0f;
 };
 
 void on_create(Laser* laser);
 void on_destroy(Laser* laser);
-void on_update(Laser* laser);
+void on_update(Laser* laser, Update_Job* job);
 void on_collision(Laser* laser, Entity* them);
 
 #else
 
 void init_laser(Laser* laser, Laser_Color color, Entity* shooter, f32 angle) {
     set_sprite(laser->entity, get_laser_sprite(color), 0.75f, 0, make_vector2(0.0f, -0.3f));
-    laser->shooter_id = shooter->id;
+    laser->entity->owner = shooter->handle;
 
-    laser->entity->position    = shooter->position + (get_direction(angle) * 0.75f);
-    laser->entity->orientation = angle;
+    set_position(laser->entity, get_position(shooter) + (get_direction(angle) * 0.75f));
+    set_orientation(laser->entity, angle);
+    set_velocity(laser->entity, get_direction(angle) * 15.0f);
 }
 
 void on_create(Laser* laser) {
@@ -30,17 +29,14 @@ void on_destroy(Laser* laser) {
 
 }
 
-void on_update(Laser* laser) {
-    if ((laser->lifetime -= timers.delta) <= 0.0f) {
-        destroy_entity(laser->entity);
-    }
-    else {
-        laser->entity->position += get_direction(laser->entity->orientation) * 15.0f * timers.delta;
+void on_update(Laser* laser, Update_Job* job) {
+    if ((laser->lifetime -= timers.tick_delta) <= 0.0f) {
+        queue_destroy(job, laser->entity);
     }
 }
 
 void on_collision(Laser* laser, Entity* them) {
-    Entity* shooter = find_entity(laser->shooter_id);
+    Entity* shooter = get_entity(laser->entity->owner);
 
     switch (them->type) {
         case ENTITY_TYPE_ASTEROID: {
@@ -6,7 +6,6 @@ struct Player {
     Entity* left_thrust  = null;
     Entity* right_thrust = null;
 
-    Vector2 velocity;
     Vector2 desired_direction;
 
     i32 last_mouse_x = 0;
@@ -25,7 +24,7 @@ struct Player {
 
 void on_create(Player* player);
 void on_destroy(Player* player);
-void on_update(Player* player);
+void on_update(Player* player, Update_Job* job);
 void on_collision(Player* player, Entity* them);
 
 void add_score(u32 score);
@@ -79,10 +78,10 @@ void on_create(Player* player) {
     player->left_thrust  = create_entity(ENTITY_TYPE_NONE, player->entity);
     player->right_thrust = create_entity(ENTITY_TYPE_NONE, player->entity);
     
-    player->left_thrust->position = make_vector2(-0.3f, -0.5f);
+    set_position(player->left_thrust, make_vector2(-0.3f, -0.5f));
     set_sprite(player->left_thrust, &sprite_thrust, 0.5f, -1);
 
-    player->right_thrust->position = make_vector2(0.3f, -0.5f);
+    set_position(player->right_thrust, make_vector2(0.3f, -0.5f));
     set_sprite(player->right_thrust, &sprite_thrust, 0.5f, -1);
 
     player->left_thrust->is_visible  = false;
@@ -96,57 +95,65 @@ void on_destroy(Player* player) {
     play_sound(get_kill_sound());
 }
 
-void on_update(Player* player) {
+void on_update(Player* player, Update_Job* job) {
+    Vector2 position = get_position(player->entity);
+    f32 orientation  = get_orientation(player->entity);
+
     Vector2 acceleration;
 
-    if (input.gamepad_left_y > 0.0f) {
-        acceleration = get_direction(player->entity->orientation) * 10.0f * input.gamepad_left_y;
+    if (tick_input.gamepad_left_y > 0.0f) {
+        acceleration = get_direction(orientation) * 10.0f * tick_input.gamepad_left_y;
     }
 
-    if (input.key_w.held) {
-        acceleration = get_direction(player->entity->orientation) * 10.0f;
+    if (tick_input.key_w.held) {
+        acceleration = get_direction(orientation) * 10.0f;
     }
 
-    player->entity->position += (player->velocity * timers.delta) + (0.5f * acceleration * square(timers.delta));
+    // @note: integrate_bodies has already moved the player by its velocity this tick
+    position += 0.5f * acceleration * square(timers.tick_delta);
+    set_position(player->entity, position);
+
+    Vector2 velocity = get_velocity(player->entity);
 
-    player->velocity += acceleration * timers.delta;
-    player->velocity -= player->velocity * 0.5f * timers.delta;
+    velocity += acceleration * timers.tick_delta;
+    velocity -= velocity * 0.5f * timers.tick_delta;
 
-    if (input.key_w.down) {
+    set_velocity(player->entity, velocity);
+
+    if (tick_input.key_w.down) {
         player->left_thrust->is_visible  = true;
         player->right_thrust->is_visible = true;
     }
 
-    if (input.key_w.up) {
+    if (tick_input.key_w.up) {
         player->left_thrust->is_visible  = false;
         player->right_thrust->is_visible = false;
     }
 
-    if (input.gamepad_right_x) {
-        f32 desired_orientation = player->entity->orientation - (3500.0f * input.gamepad_right_x * timers.delta);
+    if (tick_input.gamepad_right_x) {
+        f32 desired_orientation = orientation - (3500.0f * tick_input.gamepad_right_x * timers.tick_delta);
         player->desired_direction = get_direction(desired_orientation);
     }
 
-    if (input.mouse_x != player->last_mouse_x || input.mouse_y != player->last_mouse_y) {
-        player->desired_direction = normalize(get_world_position(input.mouse_x, input.mouse_y) - player->entity->position);
+    if (tick_input.mouse_x != player->last_mouse_x || tick_input.mouse_y != player->last_mouse_y) {
+        player->desired_direction = normalize(get_world_position(tick_input.mouse_x, tick_input.mouse_y) - position);
         
-        player->last_mouse_x = input.mouse_x;
-        player->last_mouse_y = input.mouse_y;
+        player->last_mouse_x = tick_input.mouse_x;
+        player->last_mouse_y = tick_input.mouse_y;
     }
 
-    Vector2 current_direction = get_direction(player->entity->orientation);
-    Vector2 new_direction     = lerp(current_direction, 12.5f * timers.delta, player->desired_direction);
-
-    player->entity->orientation = get_angle(new_direction);
+    Vector2 current_direction = get_direction(orientation);
+    Vector2 new_direction     = lerp(current_direction, 12.5f * timers.tick_delta, player->desired_direction);
 
-    if (input.mouse_left.down || input.gamepad_right_trigger.down) {
-        Laser* laser = create_entity(ENTITY_TYPE_LASER)->laser;
-        init_laser(laser, LASER_COLOR_BLUE, player->entity, player->entity->orientation);
+    orientation = get_angle(new_direction);
+    set_orientation(player->entity, orientation);
 
-        play_sound(get_laser_sound());
+    if (tick_input.mouse_left.down || tick_input.gamepad_right_trigger.down) {
+        queue_fire_laser(job, player->entity, LASER_COLOR_BLUE, orientation);
+        queue_play_sound(job, get_laser_sound);
     }
 
-    if (player->is_invincible && (player->invincibility_timer -= timers.delta) <= 0.0f) {
+    if (player->is_invincible && (player->invincibility_timer -= timers.tick_delta) <= 0.0f) {
         player->is_invincible = false;
     }
 }
@@ -6,7 +6,7 @@ struct Powerup {
 
 void on_create(Powerup* powerup);
 void on_destroy(Powerup* powerup);
-void on_update(Powerup* powerup);
+void on_update(Powerup* powerup, Update_Job* job);
 void on_collision(Powerup* us, Entity* them);
 
 #else
@@ -19,7 +19,7 @@ void on_destroy(Powerup* powerup) {
 
 }
 
-void on_update(Powerup* powerup) {
+void on_update(Powerup* powerup, Update_Job* job) {
 
 }
 
@@ -74,40 +74,48 @@ struct Score {
     u32 time;
 };
 
+// @note: Formatted once when the scoreboard opens and kept in the mode arena until the menu stops
+struct Scoreboard_Row {
+    utf8* rank;
+    utf8* value;
+    utf8* date;
+};
+
+Scoreboard_Row* scoreboard_rows;
+u32 scoreboard_rows_count;
+
+utf8* copy_to_mode_arena(utf8* string) {
+    u32 length = get_length(string);
+
+    utf8* result = (utf8*) arena_alloc(&mode_arena, length);
+    memcpy(result, string, length);
+
+    return result;
+}
+
 Score high_scores[10];
 
 Array<Score> sort_scores(Array<Score> scores) {
-    if (scores.count < 2) return scores;
-    u32 middle = scores.count / 2;
-    
-    Array<Score> left  = copy(&scores, 0, middle);
-    Array<Score> right = copy(&scores, middle, scores.count);
+    Array<u64> keys;
+    Array<u32> order;
+    Array<u32> order_swap;
 
-    left  = sort_scores(left);
-    right = sort_scores(right);
+    keys.allocator       = &temp_allocator;
+    order.allocator      = &temp_allocator;
+    order_swap.allocator = &temp_allocator;
 
-    Array<Score> sorted;
-    sorted.allocator = &temp_allocator;
-
-    while (left.count && right.count) {
-        if (left[0].value >= right[0].value) {
-            add(&sorted, left[0]);
-            remove(&left, 0);
-        }
-        else {
-            add(&sorted, right[0]);
-            remove(&right, 0);
-        }
+    // @note: Inverting the value sorts the highest scores first, and ties keep their file order
+    for_each (Score* score, &scores) {
+        add(&keys, (u64) ~score->value);
     }
 
-    while (left.count) {
-        add(&sorted, left[0]);
-        remove(&left, 0);
-    }
+    radix_sort(&keys, &order, &order_swap);
 
-    while (right.count) {
-        add(&sorted, right[0]);
-        remove(&right, 0);
+    Array<Score> sorted;
+    sorted.allocator = &temp_allocator;
+
+    for_each (u32* index, &order) {
+        add(&sorted, scores[*index]);
     }
 
     return sorted;
@@ -116,14 +124,17 @@ Array<Score> sort_scores(Array<Score> scores) {
 void start_menu() {
     menu_mode = MENU_MODE_MAIN;
 
+    scoreboard_rows       = null;
+    scoreboard_rows_count = 0;
+
     if (!asteroids.count) {
         for (u32 i = 0 ; i < 4; i++) {
             Asteroid* asteroid = create_entity(ENTITY_TYPE_ASTEROID)->asteroid;
             set_asteroid_size(asteroid, ASTEROID_SIZE_LARGE);
 
-            asteroid->entity->position = make_vector2(
-                get_random_between(world_left, world_right), 
-                get_random_between(world_bottom, world_top));
+            set_position(asteroid->entity, make_vector2(
+                get_random_between(&spawn_random, world_left, world_right), 
+                get_random_between(&spawn_random, world_bottom, world_top)));
         }
     }
 }
@@ -156,6 +167,9 @@ void update_menu() {
                 if (gui_button("Scoreboard", MENU_OPTION_SIZE)) {
                     menu_mode = MENU_MODE_SCOREBOARD;
 
+                    // @note: The scores only live until they are copied into high_scores
+                    Arena_Mark mark = push_arena_mark(&frame_arena, "Scoreboard");
+
                     Array<Score> scores;
                     scores.allocator = &temp_allocator;
 
@@ -188,6 +202,29 @@ void update_menu() {
                             high_scores[i].time  = 0;
                         }
                     }
+
+                    pop_arena_mark(mark);
+
+                    // @note: Rows from an earlier visit stay in the mode arena until the menu stops
+                    scoreboard_rows = (Scoreboard_Row*) arena_alloc(&mode_arena, count_of(high_scores) * size_of(Scoreboard_Row));
+                    scoreboard_rows_count = 0;
+
+                    for (u32 i = 0; i < count_of(high_scores); i++) {
+                        if (!high_scores[i].value) continue;
+
+                        time_t time_value = (time_t) high_scores[i].time;
+                        tm* gm_time = gmtime(&time_value);
+
+                        u32 month = gm_time->tm_mon + 1;
+                        u32 day   = gm_time->tm_mday;
+                        u32 year  = 1900 + gm_time->tm_year;
+
+                        Scoreboard_Row* row = &scoreboard_rows[scoreboard_rows_count++];
+
+                        row->rank  = copy_to_mode_arena(format_string("%u)", i + 1));
+                        row->value = copy_to_mode_arena(format_string("%u", high_scores[i].value));
+                        row->date  = copy_to_mode_arena(format_string("%u/%u/%u", month, day, year));
+                    }
                 }
 
                 gui_pad(get_font_line_gap(gui_context.default_font, MENU_OPTION_SIZE));
@@ -316,20 +353,13 @@ void update_menu() {
             begin_layout(GUI_ADVANCE_VERTICAL, 10.0f, GUI_ANCHOR_CENTER); {
                 gui_text("Scoreboard", MENU_TITLE_SIZE);
 
-                for (u32 i = 0; i < count_of(high_scores); i++) {
-                    if (!high_scores[i].value) continue;
-
-                    time_t time_value = (time_t) high_scores[i].time;
-                    tm* gm_time = gmtime(&time_value);
-
-                    u32 month = gm_time->tm_mon + 1;
-                    u32 day   = gm_time->tm_mday;
-                    u32 year  = 1900 + gm_time->tm_year;
+                for (u32 i = 0; i < scoreboard_rows_count; i++) {
+                    Scoreboard_Row* row = &scoreboard_rows[i];
 
                     begin_layout(GUI_ADVANCE_HORIZONTAL, 25.0f); {
-                        gui_text(format_string("%u)", i + 1), MENU_OPTION_SIZE);
-                        gui_text(format_string("%u", high_scores[i].value), MENU_OPTION_SIZE);
-                        gui_text(format_string("%u/%u/%u", month, day, year), MENU_OPTION_SIZE);
+                        gui_text(row->rank,  MENU_OPTION_SIZE);
+                        gui_text(row->value, MENU_OPTION_SIZE);
+                        gui_text(row->date,  MENU_OPTION_SIZE);
                     }
                     end_layout();
                 }
@@ -349,6 +379,8 @@ void update_menu() {
                             high_scores[i].value = 0;
                             high_scores[i].time  = 0;
                         }
+
+                        scoreboard_rows_count = 0;
                     }
                 }
                 end_layout();
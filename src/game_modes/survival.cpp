@@ -17,8 +17,8 @@ u32 player_score_since_last_life;
 
 f32 enemy_respawn_timer;
 
-Player* the_player;
-Enemy*  the_enemy;
+Entity_Handle the_player;
+Entity_Handle the_enemy;
 
 void start_level(u32 level) {
     f32 growth = powf(1.0f + LEVEL_GROWTH_RATE, (f32) level);
@@ -30,33 +30,33 @@ void start_level(u32 level) {
         Asteroid* asteroid = create_entity(ENTITY_TYPE_ASTEROID)->asteroid;
         set_asteroid_size(asteroid, ASTEROID_SIZE_LARGE);
 
-        u32 side = get_random_out_of(4);
+        u32 side = get_random_out_of(&spawn_random, 4);
         switch (side) {
             case 0: {
-                asteroid->entity->position = make_vector2(
-                    get_random_between(world_left, world_left + (world_width / 4.0f)), 
-                    get_random_between(world_bottom, world_top));
+                set_position(asteroid->entity, make_vector2(
+                    get_random_between(&spawn_random, world_left, world_left + (world_width / 4.0f)), 
+                    get_random_between(&spawn_random, world_bottom, world_top)));
 
                 break;
             }
             case 1: {
-                asteroid->entity->position = make_vector2(
-                    get_random_between(world_left, world_right), 
-                    get_random_between(world_top, world_top - (world_width / 4.0f)));
+                set_position(asteroid->entity, make_vector2(
+                    get_random_between(&spawn_random, world_left, world_right), 
+                    get_random_between(&spawn_random, world_top, world_top - (world_width / 4.0f))));
 
                 break;
             }
             case 2: {
-                asteroid->entity->position = make_vector2(
-                    get_random_between(world_right, world_right - (world_width / 4.0f)), 
-                    get_random_between(world_bottom, world_top));
+                set_position(asteroid->entity, make_vector2(
+                    get_random_between(&spawn_random, world_right, world_right - (world_width / 4.0f)), 
+                    get_random_between(&spawn_random, world_bottom, world_top)));
 
                 break;
             }
             case 3: {
-                asteroid->entity->position = make_vector2(
-                    get_random_between(world_left, world_right), 
-                    get_random_between(world_bottom, world_bottom + (world_width / 4.0f)));
+                set_position(asteroid->entity, make_vector2(
+                    get_random_between(&spawn_random, world_left, world_right), 
+                    get_random_between(&spawn_random, world_bottom, world_bottom + (world_width / 4.0f))));
 
                 break;
             }
@@ -78,40 +78,47 @@ void add_score(u32 score) {
 }
 
 void spawn_player() {
-    the_player = create_entity(ENTITY_TYPE_PLAYER)->player;
-    init_player(the_player, ship_type, ship_color);
+    Player* player = create_entity(ENTITY_TYPE_PLAYER)->player;
+    init_player(player, ship_type, ship_color);
+
+    the_player = player->entity->handle;
 }
 
 void kill_player() {
-    if (!the_player) return;
+    Entity* player = get_entity(the_player);
+    if (!player) return;
 
     player_lives -= 1;
     
-    destroy_entity(the_player->entity);
-    the_player = null;
+    destroy_entity(player);
+    the_player = Entity_Handle();
 }
 
 void spawn_enemy() {
-    the_enemy = create_entity(ENTITY_TYPE_ENEMY)->enemy;
+    Enemy* enemy = create_entity(ENTITY_TYPE_ENEMY)->enemy;
+    the_enemy = enemy->entity->handle;
 
     if (player_score >= 40000) {
-        set_enemy_mode(the_enemy, ENEMY_MODE_HARD);
+        set_enemy_mode(enemy, ENEMY_MODE_HARD);
     }
     else {
-        if (get_random_chance(4)) {
-            set_enemy_mode(the_enemy, ENEMY_MODE_HARD);
+        if (get_random_chance(&spawn_random, 4)) {
+            set_enemy_mode(enemy, ENEMY_MODE_HARD);
         }
         else {
-            set_enemy_mode(the_enemy, ENEMY_MODE_EASY);
+            set_enemy_mode(enemy, ENEMY_MODE_EASY);
         }
     }
 }
 
 void kill_enemy() {
-    destroy_entity(the_enemy->entity);
-    the_enemy = null;
+    Entity* enemy = get_entity(the_enemy);
+    if (!enemy) return;
+
+    destroy_entity(enemy);
+    the_enemy = Entity_Handle();
 
-    enemy_respawn_timer = get_random_between(5.0f, 15.0f);
+    enemy_respawn_timer = get_random_between(&spawn_random, 5.0f, 15.0f);
 }
 
 void start_survival() {
@@ -122,7 +129,7 @@ void start_survival() {
     player_score = 0;
     player_score_since_last_life = 0;
 
-    enemy_respawn_timer = get_random_between(5.0f, 15.0f);
+    enemy_respawn_timer = get_random_between(&spawn_random, 5.0f, 15.0f);
 
     start_level(1);
     spawn_player();
@@ -175,8 +182,9 @@ void update_survival() {
                 gui_pad(get_font_line_gap(gui_context.default_font, 32.0f));
 
                 if (gui_button("Quit", 32.0f)) {
-                    if (the_player) {
-                        destroy_entity(the_player->entity);
+                    Entity* player = get_entity(the_player);
+                    if (player) {
+                        destroy_entity(player);
                     }
 
                     should_simulate = true;
@@ -193,17 +201,17 @@ void update_survival() {
                 }
             }
             else {
-                if (!the_enemy && (enemy_respawn_timer -= timers.delta) <= 0.0f) {
+                if (!get_entity(the_enemy) && (enemy_respawn_timer -= timers.delta) <= 0.0f) {
                     spawn_enemy();
                 }
 
-                if (!asteroids.count && !the_enemy) {
+                if (!asteroids.count && !get_entity(the_enemy)) {
                     is_waiting_for_next_level = true;
                     next_level_timer = NEXT_LEVEL_DELAY;
                 }
             }
 
-             if (!the_player) {
+             if (!get_entity(the_player)) {
                 begin_layout(GUI_ADVANCE_VERTICAL, GUI_ANCHOR_CENTER); {
                     gui_text(format_string("You have %u lives left", player_lives), 45.0f);
                     gui_pad(10.0f);
@@ -97,6 +97,9 @@ struct Gui_Layout {
     f32 baked_width  = 0.0f;
     f32 baked_height = 0.0f;
 
+    // @note: Covers the layout's parameters and everything added to it, nested layouts included
+    u64 hash = 0;
+
     Gui_Layout* parent = null;
     Array<Gui_Entry> entries;
 };
@@ -106,6 +109,19 @@ struct Gui_Interaction {
     Rectangle2 bounds;
 };
 
+//
+// The layout tree is still built every frame, but it is hashed as it is built. When
+// the hash matches the last frame's, baking the sizes and walking the layouts is
+// skipped and every entry is drawn where it was drawn last frame. Only the per frame
+// parts of drawing an entry, the button hit test and hot highlight, run again. Text
+// quads are already kept by the text run cache.
+//
+
+struct Gui_Placement {
+    Vector2 cursor;
+    Rectangle2 layout_bounds;
+};
+
 struct Gui_Context {
     Matrix4 projection;
     Vector2 mouse_position;
@@ -119,12 +135,106 @@ struct Gui_Context {
     Gui_Interaction hot_interaction;
     Gui_Interaction active_interaction;
 
+    u64 last_layout_hash = 0;
+    Array<Gui_Placement> placements;
+
     // @todo: remove this
     u32 selected_button_id = 0;
 };
 
 Gui_Context gui_context;
 
+const u64 GUI_HASH_START = 14695981039346656037ull;
+
+u64 mix_gui_hash(u64 hash, void* data, u32 size) {
+    u8* bytes = (u8*) data;
+
+    for (u32 i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+u64 hash_gui_entry(u64 hash, Gui_Entry* entry) {
+    hash = mix_gui_hash(hash, &entry->id,     size_of(entry->id));
+    hash = mix_gui_hash(hash, &entry->type,   size_of(entry->type));
+    hash = mix_gui_hash(hash, &entry->width,  size_of(entry->width));
+    hash = mix_gui_hash(hash, &entry->height, size_of(entry->height));
+
+    switch (entry->type) {
+        case GUI_ENTRY_TYPE_PAD: {
+            hash = mix_gui_hash(hash, &entry->pad, size_of(entry->pad));
+            break;
+        }
+        case GUI_ENTRY_TYPE_TEXT:
+        case GUI_ENTRY_TYPE_BUTTON: {
+            // @note: Text and button entries share a layout
+            hash = mix_gui_hash(hash, &entry->text.font, size_of(entry->text.font));
+            hash = mix_gui_hash(hash, &entry->text.size, size_of(entry->text.size));
+            hash = mix_gui_hash(hash, entry->text.value, get_length(entry->text.value));
+
+            break;
+        }
+        case GUI_ENTRY_TYPE_FILL: {
+            hash = mix_gui_hash(hash, &entry->fill, size_of(entry->fill));
+            break;
+        }
+        case GUI_ENTRY_TYPE_IMAGE: {
+            hash = mix_gui_hash(hash, &entry->image.sprite, size_of(entry->image.sprite));
+            hash = mix_gui_hash(hash, &entry->image.size,   size_of(entry->image.size));
+
+            break;
+        }
+        case GUI_ENTRY_TYPE_RECTANGLE: {
+            // @note: Field by field, the padding after fill is never written
+            hash = mix_gui_hash(hash, &entry->rectangle.border_r, size_of(f32));
+            hash = mix_gui_hash(hash, &entry->rectangle.border_g, size_of(f32));
+            hash = mix_gui_hash(hash, &entry->rectangle.border_b, size_of(f32));
+            hash = mix_gui_hash(hash, &entry->rectangle.border_a, size_of(f32));
+            hash = mix_gui_hash(hash, &entry->rectangle.fill_r,   size_of(f32));
+            hash = mix_gui_hash(hash, &entry->rectangle.fill_g,   size_of(f32));
+            hash = mix_gui_hash(hash, &entry->rectangle.fill_b,   size_of(f32));
+            hash = mix_gui_hash(hash, &entry->rectangle.fill_a,   size_of(f32));
+            hash = mix_gui_hash(hash, &entry->rectangle.fill,     size_of(bool));
+
+            break;
+        }
+        case GUI_ENTRY_TYPE_LAYOUT: {
+            // @note: The layout's own hash is mixed into its parent when it ends
+            break;
+        }
+        invalid_default_case();
+    }
+
+    return hash;
+}
+
+u64 hash_gui_layout(Gui_Layout* layout) {
+    u64 hash = GUI_HASH_START;
+
+    hash = mix_gui_hash(hash, &layout->advance,  size_of(layout->advance));
+    hash = mix_gui_hash(hash, &layout->padding,  size_of(layout->padding));
+    hash = mix_gui_hash(hash, &layout->anchor,   size_of(layout->anchor));
+    hash = mix_gui_hash(hash, &layout->offset_x, size_of(layout->offset_x));
+    hash = mix_gui_hash(hash, &layout->offset_y, size_of(layout->offset_y));
+
+    return hash;
+}
+
+void add_gui_entry(Gui_Layout* layout, Gui_Entry entry) {
+    add(&layout->entries, entry);
+    layout->hash = hash_gui_entry(layout->hash, &entry);
+}
+
+void pop_gui_layout() {
+    Gui_Layout* layout = gui_context.layout_stack[gui_context.layout_stack.count - 1];
+    layout->parent->hash = mix_gui_hash(layout->parent->hash, &layout->hash, size_of(layout->hash));
+
+    remove(&gui_context.layout_stack, gui_context.layout_stack.count - 1);
+}
+
 void gui_begin() {
     gui_context.projection = make_orthographic_matrix(0.0f, (f32) platform.window_width, (f32) platform.window_height, 0.0f);
     
@@ -151,6 +261,10 @@ void gui_begin() {
 
     gui_context.root_layout->entries.allocator = &temp_allocator;
 
+    gui_context.root_layout->hash = hash_gui_layout(gui_context.root_layout);
+    gui_context.root_layout->hash = mix_gui_hash(gui_context.root_layout->hash, &gui_context.root_layout->baked_width,  size_of(f32));
+    gui_context.root_layout->hash = mix_gui_hash(gui_context.root_layout->hash, &gui_context.root_layout->baked_height, size_of(f32));
+
     add(&gui_context.layout_stack, gui_context.root_layout);
 }
 
@@ -195,11 +309,92 @@ void bake_layout_sizes(Gui_Layout* layout) {
     }
 }
 
+void draw_gui_entry(Gui_Entry* entry, Gui_Placement* placement) {
+    Vector2 cursor = placement->cursor;
+
+    switch (entry->type) {
+        case GUI_ENTRY_TYPE_PAD: {
+            break;
+        }
+        case GUI_ENTRY_TYPE_TEXT: {
+            cursor.y += get_font_descent(entry->text.font, entry->text.size);
+
+            set_transform(make_transform2(cursor));
+            draw_text(entry->text.font, entry->text.size, entry->text.value);
+
+            cursor.y -= get_font_descent(entry->text.font, entry->text.size);
+
+            break;
+        }
+        case GUI_ENTRY_TYPE_BUTTON: {
+            Rectangle2 dimensions = make_rectangle2(cursor, entry->width, entry->height);
+            if (contains(dimensions, gui_context.mouse_position)) {
+                gui_context.pending_interaction.id     = entry->id;
+                gui_context.pending_interaction.bounds = dimensions;
+            }
+
+            Color color = make_color(1.0f, 1.0f, 1.0f);
+            if (gui_context.hot_interaction.id == entry->id) {
+                color = make_color(1.0f, 1.0f, 0.0f);
+            }
+
+            cursor.y += get_font_descent(entry->button.font, entry->button.size);
+
+            set_transform(make_transform2(cursor));
+            draw_text(entry->button.font, entry->button.size, entry->button.value, color);
+
+            cursor.y -= get_font_descent(entry->button.font, entry->button.size);
+
+            break;
+        }
+        case GUI_ENTRY_TYPE_FILL: {
+            set_transform(make_identity_matrix());
+            
+            draw_rectangle(
+                placement->layout_bounds, 
+                make_color(entry->fill.r, entry->fill.g, entry->fill.b, entry->fill.a));
+
+            break;
+        }
+        case GUI_ENTRY_TYPE_IMAGE: {
+            set_transform(make_transform2(cursor));
+            draw_sprite(entry->image.sprite, entry->image.size, 1.0f, false);
+
+            break;
+        }
+        case GUI_ENTRY_TYPE_RECTANGLE: {
+            set_transform(make_transform2(cursor));
+
+            Rectangle2 rectangle = make_rectangle2(make_vector2(0.0f, 0.0f), entry->width, entry->height);
+
+            if (entry->rectangle.fill) {
+                draw_rectangle(
+                    rectangle, 
+                    make_color(entry->rectangle.fill_r, entry->rectangle.fill_g, entry->rectangle.fill_b, entry->rectangle.fill_a), 
+                    true);
+            }
+
+            draw_rectangle(
+                rectangle, 
+                make_color(entry->rectangle.border_r, entry->rectangle.border_g, entry->rectangle.border_b, entry->rectangle.border_a), 
+                false);
+
+            break;
+        }
+        invalid_default_case();
+    }
+
+    #if DEBUG && DRAW_GUI_BOUNDS
+        set_transform(make_identity_matrix());
+        draw_rectangle(make_rectangle2(cursor, entry->width, entry->height), make_color(0.0f, 1.0f, 0.0f), false);
+    #endif
+}
+
 void draw_layout_entries(Gui_Layout* layout, Vector2 cursor) {
     Vector2 layout_position = make_vector2(cursor.x, cursor.y - layout->baked_height);
 
     #if DEBUG && DRAW_GUI_BOUNDS
-        set_transform(make_transform_matrix(layout_position));
+        set_transform(make_transform2(layout_position));
         
         draw_rectangle(
             make_rectangle2(make_vector2(-5.0f, -5.0f), layout->baked_width + 10.0f, layout->baked_height + 10.0f), 
@@ -260,94 +455,24 @@ void draw_layout_entries(Gui_Layout* layout, Vector2 cursor) {
 
         cursor.y -= entry->height;
 
-        switch (entry->type) {
-            case GUI_ENTRY_TYPE_PAD: {
-                break;
-            }
-            case GUI_ENTRY_TYPE_TEXT: {
-                cursor.y += get_font_descent(entry->text.font, entry->text.size);
-
-                set_transform(make_transform_matrix(cursor));
-                draw_text(entry->text.font, entry->text.size, entry->text.value);
-
-                cursor.y -= get_font_descent(entry->text.font, entry->text.size);
-
-                break;
-            }
-            case GUI_ENTRY_TYPE_BUTTON: {
-                Rectangle2 dimensions = make_rectangle2(cursor, entry->width, entry->height);
-                if (contains(dimensions, gui_context.mouse_position)) {
-                    gui_context.pending_interaction.id     = entry->id;
-                    gui_context.pending_interaction.bounds = dimensions;
-                }
-
-                Color color = make_color(1.0f, 1.0f, 1.0f);
-                if (gui_context.hot_interaction.id == entry->id) {
-                    color = make_color(1.0f, 1.0f, 0.0f);
-                }
-
-                cursor.y += get_font_descent(entry->button.font, entry->button.size);
-
-                set_transform(make_transform_matrix(cursor));
-                draw_text(entry->button.font, entry->button.size, entry->button.value, color);
-
-                cursor.y -= get_font_descent(entry->button.font, entry->button.size);
-
-                break;
-            }
-            case GUI_ENTRY_TYPE_FILL: {
-                set_transform(make_identity_matrix());
-                
-                draw_rectangle(
-                    make_rectangle2(layout_position, layout->baked_width, layout->baked_height), 
-                    make_color(entry->fill.r, entry->fill.g, entry->fill.b, entry->fill.a));
-
-                break;
-            }
-            case GUI_ENTRY_TYPE_IMAGE: {
-                set_transform(make_transform_matrix(cursor));
-                draw_sprite(entry->image.sprite, entry->image.size, 1.0f, false);
-
-                break;
-            }
-            case GUI_ENTRY_TYPE_RECTANGLE: {
-                set_transform(make_transform_matrix(cursor));
-
-                Rectangle2 rectangle = make_rectangle2(make_vector2(0.0f, 0.0f), entry->width, entry->height);
-
-                if (entry->rectangle.fill) {
-                    draw_rectangle(
-                        rectangle, 
-                        make_color(entry->rectangle.fill_r, entry->rectangle.fill_g, entry->rectangle.fill_b, entry->rectangle.fill_a), 
-                        true);
-                }
+        if (entry->type == GUI_ENTRY_TYPE_LAYOUT) {
+            Gui_Layout* child_layout = entry->layout;
+            Vector2     child_cursor = cursor;
 
-                draw_rectangle(
-                    rectangle, 
-                    make_color(entry->rectangle.border_r, entry->rectangle.border_g, entry->rectangle.border_b, entry->rectangle.border_a), 
-                    false);
+            child_cursor.x += child_layout->offset_x;
+            child_cursor.y += entry->height;
 
-                break;
-            }
-            case GUI_ENTRY_TYPE_LAYOUT: {
-                Gui_Layout* child_layout = entry->layout;
-                Vector2     child_cursor = cursor;
+            draw_layout_entries(child_layout, child_cursor);
+        }
+        else {
+            Gui_Placement* placement = next(&gui_context.placements);
 
-                child_cursor.x += child_layout->offset_x;
-                child_cursor.y += entry->height;
+            placement->cursor        = cursor;
+            placement->layout_bounds = make_rectangle2(layout_position, layout->baked_width, layout->baked_height);
 
-                draw_layout_entries(child_layout, child_cursor);
-                break;
-            }
+            draw_gui_entry(entry, placement);
         }
 
-        #if DEBUG && DRAW_GUI_BOUNDS
-            if (entry->type != GUI_ENTRY_TYPE_LAYOUT) {
-                set_transform(make_identity_matrix());
-                draw_rectangle(make_rectangle2(cursor, entry->width, entry->height), make_color(0.0f, 1.0f, 0.0f), false);
-            }
-        #endif
-
         cursor.y += entry->height;
 
         switch (layout->advance) {
@@ -368,11 +493,39 @@ void draw_layout_entries(Gui_Layout* layout, Vector2 cursor) {
     }
 }
 
+void replay_layout_entries(Gui_Layout* layout, u32* placement_index) {
+    for_each (Gui_Entry* entry, &layout->entries) {
+        if (entry->type == GUI_ENTRY_TYPE_LAYOUT) {
+            replay_layout_entries(entry->layout, placement_index);
+            continue;
+        }
+
+        draw_gui_entry(entry, &gui_context.placements[*placement_index]);
+        *placement_index += 1;
+    }
+}
+
 void gui_end() {
-    bake_layout_sizes(gui_context.root_layout);
+    // @note: A layout that was never ended still has to reach the root's hash
+    while (gui_context.layout_stack.count > 1) {
+        pop_gui_layout();
+    }
 
+    Gui_Layout* root_layout = gui_context.root_layout;
     set_projection(gui_context.projection);
-    draw_layout_entries(gui_context.root_layout, make_vector2(0.0f, gui_context.root_layout->baked_height));
+
+    if (root_layout->hash == gui_context.last_layout_hash && !DRAW_GUI_BOUNDS) {
+        u32 placement_index = 0;
+        replay_layout_entries(root_layout, &placement_index);
+    }
+    else {
+        bake_layout_sizes(root_layout);
+
+        gui_context.placements.count = 0;
+        draw_layout_entries(root_layout, make_vector2(0.0f, root_layout->baked_height));
+
+        gui_context.last_layout_hash = root_layout->hash;
+    }
 
     gui_context.selected_button_id = 0;
 
@@ -415,12 +568,14 @@ void begin_layout(Gui_Advance advance, f32 padding, Gui_Anchor anchor = GUI_ANCH
     layout->parent = get_current_layout();
     layout->entries.allocator = &temp_allocator;
 
+    layout->hash = hash_gui_layout(layout);
+
     Gui_Entry entry;
     
     entry.type   = GUI_ENTRY_TYPE_LAYOUT;
     entry.layout = layout;
 
-    add(&layout->parent->entries, entry);
+    add_gui_entry(layout->parent, entry);
     add(&gui_context.layout_stack, layout);
 }
 
@@ -429,7 +584,7 @@ void begin_layout(Gui_Advance advance = GUI_ADVANCE_VERTICAL, Gui_Anchor anchor
 }
 
 void end_layout() {
-    remove(&gui_context.layout_stack, gui_context.layout_stack.count - 1);
+    pop_gui_layout();
 }
 
 void gui_pad(f32 padding) {
@@ -450,7 +605,7 @@ void gui_pad(f32 padding) {
         invalid_default_case();
     }
 
-    add(&get_current_layout()->entries, entry);
+    add_gui_entry(get_current_layout(), entry);
 }
 
 void gui_text(Font* font, utf8* text, f32 size) {
@@ -464,7 +619,7 @@ void gui_text(Font* font, utf8* text, f32 size) {
     entry.text.value = text;
     entry.text.size  = size;
 
-    add(&get_current_layout()->entries, entry);
+    add_gui_entry(get_current_layout(), entry);
 }
 
 void gui_text(utf8* text, f32 size) {
@@ -484,7 +639,7 @@ bool gui_button(u32 id, Font* font, utf8* text, f32 size) {
     entry.button.value = text;
     entry.button.size  = size;
 
-    add(&get_current_layout()->entries, entry);
+    add_gui_entry(get_current_layout(), entry);
 
     return entry.id == gui_context.selected_button_id;
 }
@@ -506,7 +661,7 @@ void gui_fill(Color color) {
     entry.fill.b = color.b;
     entry.fill.a = color.a;
 
-    add(&get_current_layout()->entries, entry);
+    add_gui_entry(get_current_layout(), entry);
 }
 
 void gui_image(Sprite* sprite, f32 size) {
@@ -519,7 +674,7 @@ void gui_image(Sprite* sprite, f32 size) {
     entry.image.sprite = sprite;
     entry.image.size   = size;
 
-    add(&get_current_layout()->entries, entry);
+    add_gui_entry(get_current_layout(), entry);
 }
 
 void gui_rectangle(f32 width, f32 height, Color border_color, Color fill_color, bool fill = true) {
@@ -541,7 +696,7 @@ void gui_rectangle(f32 width, f32 height, Color border_color, Color fill_color,
 
     entry.rectangle.fill = fill;
 
-    add(&get_current_layout()->entries, entry);
+    add_gui_entry(get_current_layout(), entry);
 }
 
 void gui_rectangle(f32 width, f32 height, Color border_color) {
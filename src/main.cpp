@@ -53,6 +53,69 @@ utf8* to_string(Game_Mode game_mode) {
 Game_Mode game_mode;
 void switch_game_mode(Game_Mode new_game_mode);
 
+struct Command_Line {
+    Game_Mode start_mode = GAME_MODE_MENU;
+    u32       tick_rate  = 60;
+
+    bool has_seed = false;
+    u64  seed     = 0;
+
+    utf8* record_file_name  = null;
+    utf8* replay_file_name  = null;
+    utf8* timings_file_name = null;
+
+    // @note: Zero uses one thread per processor
+    u32 threads = 0;
+
+    // @note: Only used by headless builds
+    u32   frames       = 0;
+    utf8* input_script = null;
+};
+
+Command_Line parse_command_line(i32 argument_count, utf8** arguments) {
+    Command_Line command_line;
+
+    for (i32 i = 1; i < argument_count; i++) {
+        utf8* argument = arguments[i];
+        bool  has_value = i + 1 < argument_count;
+
+        if (compare(argument, "-survival")) {
+            command_line.start_mode = GAME_MODE_SURVIVAL;
+        }
+        else if (compare(argument, "-tick_rate") && has_value) {
+            command_line.tick_rate = (u32) atoi(arguments[++i]);
+            if (!command_line.tick_rate) command_line.tick_rate = 60;
+        }
+        else if (compare(argument, "-seed") && has_value) {
+            command_line.seed     = strtoull(arguments[++i], null, 10);
+            command_line.has_seed = true;
+        }
+        else if (compare(argument, "-record") && has_value) {
+            command_line.record_file_name = arguments[++i];
+        }
+        else if (compare(argument, "-replay") && has_value) {
+            command_line.replay_file_name = arguments[++i];
+        }
+        else if (compare(argument, "-timings") && has_value) {
+            command_line.timings_file_name = arguments[++i];
+        }
+        else if (compare(argument, "-threads") && has_value) {
+            command_line.threads = (u32) atoi(arguments[++i]);
+        }
+        else if (compare(argument, "-frames") && has_value) {
+            command_line.frames = (u32) atoi(arguments[++i]);
+        }
+        else if (compare(argument, "-script") && has_value) {
+            command_line.input_script = arguments[++i];
+        }
+        else {
+            printf("Unknown command line argument '%s'\n", argument);
+        }
+    }
+
+    return command_line;
+}
+
 #include "game_modes/menu.cpp"
 #include "game_modes/survival.cpp"
 
@@ -72,6 +135,9 @@ void switch_game_mode(Game_Mode new_game_mode) {
         invalid_default_case();
     }
 
+    // @note: Whatever the old mode kept in the mode arena is gone now
+    reset_arena(&mode_arena);
+
     switch (new_game_mode) {
         case GAME_MODE_MENU: {
             start_menu();
@@ -96,7 +162,7 @@ void draw_bucket_storage(Bucket_Array<type, size>* bucket_array) {
 
             begin_layout(GUI_ADVANCE_HORIZONTAL); {
                 for (u32 j = 0; j < size; j++) {
-                    if (bucket_array->buckets[i]->occupied[j]) {
+                    if (is_occupied(bucket_array->buckets[i], j)) {
                         gui_rectangle(16.0f, 16.0f, make_color(0.0f, 0.0f, 0.0f), make_color(1.0f, 0.0f, 0.0f));
                     }
                     else {
@@ -112,6 +178,105 @@ void draw_bucket_storage(Bucket_Array<type, size>* bucket_array) {
     end_layout();
 }
 
+template<typename type, u32 size>
+void draw_pool_usage(utf8* name, Bucket_Array<type, size>* pool) {
+    gui_text(&font_arial, format_string("%s: %u / %u", name, pool->count, pool->buckets.count * size), 18.0f);
+    draw_bucket_storage(pool);
+}
+
+// @note: Keeps a slow frame from asking for more ticks than it can run, which would
+// make the next frame slower still
+const u32 MAX_TICKS_PER_FRAME = 8;
+
+u64 total_ticks;
+f64 total_tick_seconds;
+f64 frame_tick_seconds;
+f32 last_tick_milliseconds;
+
+void simulate_ticks() {
+    accumulate_tick_input();
+    frame_tick_seconds = 0.0;
+
+    timers.tick_accumulator += timers.delta;
+    timers.ticks = 0;
+
+    while (timers.tick_accumulator >= timers.tick_delta) {
+        if (timers.ticks == MAX_TICKS_PER_FRAME) {
+            timers.tick_accumulator = 0.0f;
+            break;
+        }
+
+        f64 tick_start = get_wall_clock();
+
+        // @note: Nothing allocated from the frame arena during a tick outlives it
+        Arena_Mark mark = push_arena_mark(&frame_arena, "Tick");
+
+        if (should_simulate) {
+            update_entities();
+            update_particles();
+        }
+
+        pop_arena_mark(mark);
+
+        f64 tick_seconds = get_wall_clock() - tick_start;
+
+        total_ticks        += 1;
+        total_tick_seconds += tick_seconds;
+        frame_tick_seconds += tick_seconds;
+
+        last_tick_milliseconds = (f32) (tick_seconds * 1000.0);
+
+        consume_tick_input();
+
+        timers.tick_accumulator -= timers.tick_delta;
+        timers.ticks += 1;
+    }
+
+    // @note: A paused simulation is drawn where it stopped
+    timers.tick_interpolation = should_simulate ? timers.tick_accumulator / timers.tick_delta : 1.0f;
+}
+
+void draw_arena_usage(Arena* arena) {
+    gui_text(
+        &font_arial, 
+        format_string("%s arena: %.2f kb / %.2f kb (max: %.2f kb, %u blocks)", 
+            arena->name, 
+            arena->allocated / 1024.0f, 
+            arena->block_size / 1024.0f, 
+            arena->high_water_mark / 1024.0f, 
+            arena->blocks),
+        18.0f);
+
+    gui_pad(5.0f);
+
+    begin_layout(GUI_ADVANCE_HORIZONTAL); {
+        f32 full = (f32) arena->allocated       / (f32) arena->block_size;
+        f32 high = (f32) arena->high_water_mark / (f32) arena->block_size;
+
+        if (full > 1.0f) full = 1.0f;
+        if (high > 1.0f) high = 1.0f;
+
+        f32 empty = 1.0f - high;
+
+        gui_rectangle(256.0f * full,          16.0f, make_color(0.0f, 0.0f, 0.0f), make_color(1.0f, 1.0f, 0.0f));
+        gui_rectangle(256.0f * (high - full), 16.0f, make_color(0.0f, 0.0f, 0.0f), make_color(0.0f, 1.0f, 1.0f));
+        gui_rectangle(256.0f * empty,         16.0f, make_color(0.0f, 0.0f, 0.0f));
+    }
+    end_layout();
+
+    gui_pad(5.0f);
+
+    for (u32 i = 0; i < arena_scope_stats_count; i++) {
+        Arena_Scope_Stats* stats = &arena_scope_stats[i];
+        if (stats->arena != arena) continue;
+
+        gui_text(
+            &font_arial, 
+            format_string("    %s: %.2f kb (max: %.2f kb)", stats->name, stats->last_peak / 1024.0f, stats->peak / 1024.0f), 
+            18.0f);
+    }
+}
+
 void update_world_projection() {
     world_height = 15.0f;
     world_width  = world_height * ((f32) platform.window_width / (f32) platform.window_height);
@@ -124,9 +289,55 @@ void update_world_projection() {
     world_projection = make_orthographic_matrix(world_left, world_right, world_top, world_bottom, -10.0f, 10.0f);
 }
 
-i32 main() {
-    seed_random();
+i32 main(i32 argument_count, utf8** arguments) {
+    Command_Line command_line = parse_command_line(argument_count, arguments);
+
     init_platform();
+    init_job_system(command_line.threads);
+
+    // @note: A replay plays back with the seed, tick rate and game mode it was recorded with
+    if (command_line.replay_file_name) {
+        Recording_Header header;
+
+        if (start_replay(command_line.replay_file_name, &header)) {
+            command_line.has_seed   = true;
+            command_line.seed       = header.seed;
+            command_line.tick_rate  = header.tick_rate;
+            command_line.start_mode = (Game_Mode) header.start_mode;
+        }
+    }
+
+    // @note: Headless runs are benchmarks, so they repeat the same game unless told otherwise
+    #if HEADLESS
+        u64 default_seed = 1;
+    #else
+        u64 default_seed = (u64) time(null);
+    #endif
+
+    seed_random(command_line.has_seed ? command_line.seed : default_seed);
+    printf("Random seed: %llu\n", (unsigned long long) random_seed);
+
+    if (command_line.record_file_name && !command_line.replay_file_name) {
+        start_recording(command_line.record_file_name, random_seed, command_line.tick_rate, command_line.start_mode);
+    }
+
+    // @note: One row per frame, the times are in milliseconds
+    FILE* timings_file = null;
+
+    if (command_line.timings_file_name) {
+        timings_file = fopen(command_line.timings_file_name, "wb");
+
+        if (timings_file) {
+            fprintf(timings_file, "frame,delta,frame_time,ticks,tick_time,entities,draw_calls\n");
+        }
+        else {
+            printf("Failed to open timings file '%s'\n", command_line.timings_file_name);
+        }
+    }
+
+    u32 frame = 0;
+
+    timers.tick_delta = 1.0f / (f32) command_line.tick_rate;
 
     heap_allocator    = make_allocator(heap_alloc, heap_dealloc);
     temp_allocator    = make_allocator(temp_alloc, temp_dealloc);
@@ -134,6 +345,7 @@ i32 main() {
     
     init_draw();
     init_sound();
+    init_entities();
     
     load_settings();
     show_window();
@@ -143,12 +355,30 @@ i32 main() {
     playing_music = play_sound(&sound_music, music_volume, true);
     update_world_projection();
 
-    switch_game_mode(GAME_MODE_MENU);
+    switch_game_mode(command_line.start_mode);
+
+    #if HEADLESS
+        // @note: A replay runs until it runs out of frames
+        if (command_line.frames || recording.mode != RECORDING_MODE_REPLAY) {
+            platform.frame_limit = command_line.frames ? command_line.frames : 60 * 60;
+        }
+
+        if (command_line.input_script) load_input_script(command_line.input_script);
+
+        f64 headless_start = get_wall_clock();
+    #endif
 
     while (!platform.should_quit) {
+        f64 frame_start = get_wall_clock();
+
         update_platform();
+        if (platform.should_quit && recording.mode == RECORDING_MODE_REPLAY) break;
+
         update_sound();
 
+        reset_draw_stats();
+        transforms_rebuilt = 0;
+
         glClearColor(1.0f, 0.0f, 1.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
@@ -160,10 +390,7 @@ i32 main() {
         music_volume = lerp(music_volume, 0.05f * timers.delta, 0.5f);
         set_volume(playing_music, music_volume);
 
-        if (should_simulate) {
-            update_entities();
-            update_particles();
-        }
+        simulate_ticks();
 
         set_projection(world_projection);
 
@@ -177,11 +404,12 @@ i32 main() {
                 Vector2 position = make_vector2(world_left, world_bottom);
                 position += make_vector2((f32) x, (f32) y) * tile_size;
 
-                set_transform(make_transform_matrix(position));
-                draw_sprite(&sprite_background, tile_size, 1.0f, false);
+                batch_sprite(&sprite_background, make_transform2(position), tile_size, 1.0f, false);
             }
         }
 
+        flush_sprite_batch();
+
         draw_entities();
         draw_particles();
 
@@ -205,37 +433,44 @@ i32 main() {
                     gui_text(&font_arial, format_string("Now: %.2f", timers.now), 18.0f);
                     gui_text(&font_arial, format_string("Frame: %fms", timers.delta * 1000.0f), 18.0f);
                     gui_text(&font_arial, format_string("Fps: %u", (u32) (1.0f / timers.delta)), 18.0f);
+                    gui_text(&font_arial, format_string("Ticks: %u at %u hz (%.3fms per tick)", timers.ticks, command_line.tick_rate, last_tick_milliseconds), 18.0f);
+                }
+                end_layout();
+
+                gui_text(&font_arial, "Rendering:", 18.0f);
+
+                begin_layout(GUI_ADVANCE_VERTICAL, get_font_line_gap(&font_arial, 18.0f), GUI_ANCHOR_NONE, 16.0f); {
+                    gui_text(&font_arial, format_string("Draw calls: %u", last_draw_stats.draw_calls), 18.0f);
+                    gui_text(&font_arial, format_string("Vertices: %u", last_draw_stats.vertices), 18.0f);
+                    gui_text(&font_arial, format_string("Text runs: %u hits, %u misses", text_run_cache.hits, text_run_cache.misses), 18.0f);
+                    gui_text(&font_arial, format_string("Glyph pages: %u of %u (%u evictions)", glyph_atlas.pages_count, GLYPH_PAGE_COUNT, glyph_atlas.evictions), 18.0f);
                 }
                 end_layout();
 
                 gui_text(&font_arial, "Storage:", 18.0f);
 
                 begin_layout(GUI_ADVANCE_VERTICAL, GUI_ANCHOR_NONE, 16.0f); {
-                    gui_text(&font_arial, format_string("Heap: %.2f mb", platform.heap_memory_allocated / 1024.0f), 18.0f);
-                    gui_pad(get_font_line_gap(&font_arial, 18.0f));
-
                     gui_text(
                         &font_arial, 
-                        format_string("Temp: %.2f kb / %.2f kb (max: %.2f kb)", 
-                            platform.temp_memory_allocated / 1024.0f, 
-                            TEMP_MEMORY_SIZE / 1024.0f, 
-                            platform.temp_memory_high_water_mark / 1024.0f),
+                        format_string(
+                            "Heap: %.2f mb (peak %.2f mb, reserved %.2f mb)", 
+                            platform.heap_memory_allocated       / (1024.0f * 1024.0f), 
+                            platform.heap_memory_high_water_mark / (1024.0f * 1024.0f), 
+                            platform.heap_memory_reserved        / (1024.0f * 1024.0f)), 
                         18.0f);
 
-                    gui_pad(5.0f);
+                    begin_layout(GUI_ADVANCE_VERTICAL, GUI_ANCHOR_NONE, 16.0f); {
+                        for (u32 i = 0; i < HEAP_TAG_COUNT; i++) {
+                            gui_text(&font_arial, format_string("%s: %.2f kb", to_string((Heap_Tag) i), platform.heap_memory_by_tag[i] / 1024.0f), 18.0f);
+                        }
+                    }
+                    end_layout();
 
-                    begin_layout(GUI_ADVANCE_HORIZONTAL); {
-                        f32 full = (f32) platform.temp_memory_allocated / (f32) TEMP_MEMORY_SIZE;
-                        f32 high = (f32) platform.temp_memory_high_water_mark / (f32) TEMP_MEMORY_SIZE;
+                    gui_pad(get_font_line_gap(&font_arial, 18.0f));
 
-                        f32 empty = 1.0f - high;
+                    draw_arena_usage(&frame_arena);
+                    draw_arena_usage(&mode_arena);
 
-                        gui_rectangle(256.0f * full,          16.0f, make_color(0.0f, 0.0f, 0.0f), make_color(1.0f, 1.0f, 0.0f));
-                        gui_rectangle(256.0f * (high - full), 16.0f, make_color(0.0f, 0.0f, 0.0f), make_color(0.0f, 1.0f, 1.0f));
-                        gui_rectangle(256.0f * empty,         16.0f, make_color(0.0f, 0.0f, 0.0f));
-                    }
-                    end_layout();
-                    
                     gui_pad(5.0f);
 
                     gui_text(
@@ -245,37 +480,15 @@ i32 main() {
 
                     draw_bucket_storage(&entities);
 
-                    gui_text(
-                        &font_arial, 
-                        format_string("Players: %u / %u", players.count, players.buckets.count * PLAYERS_BUCKET_SIZE), 
-                        18.0f);
-                        
-                    draw_bucket_storage(&players);
+                    #define DRAW_ENTITY_POOL(NAME, Type, name, pool, bucket_size, collides_with) draw_pool_usage(to_string(ENTITY_TYPE_##NAME), &pool);
 
-                    gui_text(
-                        &font_arial, 
-                        format_string("Lasers: %u / %u", lasers.count, lasers.buckets.count * LASERS_BUCKET_SIZE), 
-                        18.0f);
-                        
-                    draw_bucket_storage(&lasers);
+                    ENTITY_TYPES(DRAW_ENTITY_POOL)
 
-                    gui_text(
-                        &font_arial, 
-                        format_string("Asteroids: %u / %u", asteroids.count, asteroids.buckets.count * ASTEROIDS_BUCKET_SIZE), 
-                        18.0f);
-                        
-                    draw_bucket_storage(&asteroids);
-                    
-                    gui_text(
-                        &font_arial, 
-                        format_string("Enemies: %u / %u", enemies.count, enemies.buckets.count * ENEMIES_BUCKET_SIZE), 
-                        18.0f);
-                        
-                    draw_bucket_storage(&enemies);
+                    #undef DRAW_ENTITY_POOL
                 }
                 end_layout();
 
-                gui_text(&font_arial, "Hierarchy:", 18.0f);
+                gui_text(&font_arial, format_string("Hierarchy: (%u transforms rebuilt)", transforms_rebuilt), 18.0f);
                 draw_entity_hierarchy(&root_entity);
             }
             end_layout();
@@ -283,7 +496,55 @@ i32 main() {
         
         gui_end();
         swap_buffers();
+
+        if (timings_file) {
+            f64 frame_seconds = get_wall_clock() - frame_start;
+
+            fprintf(
+                timings_file, 
+                "%u,%.4f,%.4f,%u,%.4f,%u,%u\n", 
+                frame, 
+                timers.delta * 1000.0f, 
+                frame_seconds * 1000.0, 
+                timers.ticks, 
+                frame_tick_seconds * 1000.0, 
+                entities.count, 
+                draw_stats.draw_calls);
+        }
+
+        frame += 1;
     }
+
+    stop_recording();
+    if (timings_file) fclose(timings_file);
+
+    #if HEADLESS
+        f64 headless_seconds = get_wall_clock() - headless_start;
+
+        printf(
+            "Ran %u headless frames in %.3f s (%.3f ms per frame)\n", 
+            frame, 
+            headless_seconds, 
+            headless_seconds * 1000.0 / (f64) frame);
+
+        if (total_ticks) {
+            printf(
+                "Ran %llu ticks at %u hz (%.3f ms per tick)\n", 
+                (unsigned long long) total_ticks, 
+                command_line.tick_rate, 
+                total_tick_seconds * 1000.0 / (f64) total_ticks);
+        }
+
+        printf(
+            "Heap %u bytes in use, %u bytes peak, %u bytes reserved\n", 
+            platform.heap_memory_allocated, 
+            platform.heap_memory_high_water_mark, 
+            platform.heap_memory_reserved);
+
+        for (u32 i = 0; i < HEAP_TAG_COUNT; i++) {
+            printf("    %s: %u bytes\n", to_string((Heap_Tag) i), platform.heap_memory_by_tag[i]);
+        }
+    #endif
     
     return 0;
 }
\ No newline at end of file
@@ -6,6 +6,10 @@ f32 square(f32 x) {
     return x * x;
 }
 
+f32 absolute(f32 x) {
+    return x < 0.0f ? -x : x;
+}
+
 f32 to_radians(f32 degrees) {
     return degrees * PI / 180.0f;
 }
@@ -18,37 +22,118 @@ f32 lerp(f32 from, f32 step, f32 to) {
     return ((1.0f - step) * from) + (step * to);
 }
 
-void seed_random() {
-    srand((u32) time(null));
+//
+// Random numbers come from xoshiro128** generators with explicit state. Each
+// subsystem draws from its own stream, so spawning more particles doesn't change
+// where the next asteroid spawns, and every stream is derived from one seed so a
+// run can be repeated exactly. See http://prng.di.unimi.it for the generator.
+//
+
+struct Random {
+    u32 state[4];
+};
+
+Random spawn_random;
+Random particles_random;
+Random ai_random;
+Random sound_random;
+
+u64 random_seed;
+
+u64 split_mix(u64* value) {
+    u64 result = (*value += 0x9E3779B97F4A7C15);
+
+    result = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9;
+    result = (result ^ (result >> 27)) * 0x94D049BB133111EB;
+
+    return result ^ (result >> 31);
 }
 
-u32 get_random_u32() {
-    u32 result = rand();
+Random make_random(u64 seed, u32 stream) {
+    Random random;
+
+    u64 value = seed ^ ((u64) (stream + 1) * 0xD1B54A32D192ED03);
+
+    u64 a = split_mix(&value);
+    u64 b = split_mix(&value);
+
+    random.state[0] = (u32) a;
+    random.state[1] = (u32) (a >> 32);
+    random.state[2] = (u32) b;
+    random.state[3] = (u32) (b >> 32);
+
+    // @note: The all zero state never leaves zero
+    if (!(random.state[0] | random.state[1] | random.state[2] | random.state[3])) {
+        random.state[0] = 1;
+    }
+
+    return random;
+}
+
+void seed_random(u64 seed) {
+    random_seed = seed;
+
+    spawn_random     = make_random(seed, 0);
+    particles_random = make_random(seed, 1);
+    ai_random        = make_random(seed, 2);
+    sound_random     = make_random(seed, 3);
+}
+
+u32 rotate_left(u32 value, u32 count) {
+    return (value << count) | (value >> (32 - count));
+}
+
+u32 get_random_u32(Random* random) {
+    u32* state = random->state;
+
+    u32 result = rotate_left(state[1] * 5, 7) * 9;
+    u32 t = state[1] << 9;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3]  = rotate_left(state[3], 11);
+
     return result;
 }
 
-u32 get_random_out_of(u32 count) {
-    return get_random_u32() % count;
+// @note: Multiply and shift instead of a modulo, which is faster and less biased
+u32 get_random_out_of(Random* random, u32 count) {
+    return (u32) (((u64) get_random_u32(random) * count) >> 32);
 }
 
-bool get_random_chance(u32 chance) {
-    return get_random_out_of(chance) == chance - 1;
+bool get_random_chance(Random* random, u32 chance) {
+    return get_random_out_of(random, chance) == chance - 1;
 }
 
-f32 get_random_unilateral() {
-    return (f32) get_random_u32() / (f32) RAND_MAX;
+// @note: The top 24 bits fill a float mantissa exactly, the result is in [0, 1)
+f32 get_random_unilateral(Random* random) {
+    return (f32) (get_random_u32(random) >> 8) * (1.0f / 16777216.0f);
 }
 
-f32 get_random_bilateral() {
-    return (2.0f * get_random_unilateral()) - 1.0f;
+f32 get_random_bilateral(Random* random) {
+    return (2.0f * get_random_unilateral(random)) - 1.0f;
 }
 
-f32 get_random_between(f32 min, f32 max) {
-    return lerp(min, get_random_unilateral(), max);
+f32 get_random_between(Random* random, f32 min, f32 max) {
+    return lerp(min, get_random_unilateral(random), max);
 }
 
-i32 get_random_between(i32 min, i32 max) {
-    return min + ((i32) get_random_u32() % ((max + 1) - min));
+i32 get_random_between(Random* random, i32 min, i32 max) {
+    return min + (i32) get_random_out_of(random, (u32) ((max + 1) - min));
+}
+
+// @note: For hot loops that want many numbers at once, values are in [0, 1)
+void get_random_unilaterals(Random* random, f32* values, u32 count) {
+    Random local = *random;
+
+    for (u32 i = 0; i < count; i++) {
+        values[i] = (f32) (get_random_u32(&local) >> 8) * (1.0f / 16777216.0f);
+    }
+
+    *random = local;
 }
 
 struct Vector2 {
@@ -298,6 +383,88 @@ Matrix4 make_transform_matrix(Vector2 position, f32 orientation = 0.0f, f32 scal
     return translation * rotation * scalar;
 }
 
+//
+// Transform2 is a 2D affine transform (a 2x3 matrix) with the same column naming
+// as Matrix4, where _11/_12 and _21/_22 are the x and y axes and _31/_32 is the
+// translation. It is all the entity hierarchy needs and is only expanded to a
+// Matrix4 when it is handed to the renderer.
+//
+
+struct Transform2 {
+    f32 _11 = 1.0f;
+    f32 _12 = 0.0f;
+    f32 _21 = 0.0f;
+    f32 _22 = 1.0f;
+    f32 _31 = 0.0f;
+    f32 _32 = 0.0f;
+};
+
+Transform2 make_transform2(Vector2 position, f32 orientation = 0.0f, f32 scale = 1.0f) {
+    Transform2 transform;
+
+    f32 s = sinf(to_radians(orientation)) * scale;
+    f32 c = cosf(to_radians(orientation)) * scale;
+
+    transform._11 =  c;
+    transform._12 =  s;
+    transform._21 = -s;
+    transform._22 =  c;
+    transform._31 = position.x;
+    transform._32 = position.y;
+
+    return transform;
+}
+
+Transform2 operator *(Transform2 a, Transform2 b) {
+    Transform2 transform;
+
+    transform._11 = (a._11 * b._11) + (a._21 * b._12);
+    transform._12 = (a._12 * b._11) + (a._22 * b._12);
+    transform._21 = (a._11 * b._21) + (a._21 * b._22);
+    transform._22 = (a._12 * b._21) + (a._22 * b._22);
+    transform._31 = (a._11 * b._31) + (a._21 * b._32) + a._31;
+    transform._32 = (a._12 * b._31) + (a._22 * b._32) + a._32;
+
+    return transform;
+}
+
+Vector2 operator *(Transform2 transform, Vector2 vector) {
+    f32 x = (transform._11 * vector.x) + (transform._21 * vector.y) + transform._31;
+    f32 y = (transform._12 * vector.x) + (transform._22 * vector.y) + transform._32;
+
+    return make_vector2(x, y);
+}
+
+// @note: Takes the transforms apart into position, orientation and uniform scale and
+// blends those, turning the short way round, so a spinning sprite keeps its size
+Transform2 lerp(Transform2 from, f32 step, Transform2 to) {
+    f32 from_orientation = to_degrees(atan2f(from._12, from._11));
+    f32 to_orientation   = to_degrees(atan2f(to._12,   to._11));
+
+    f32 turn = to_orientation - from_orientation;
+    if (turn >  180.0f) turn -= 360.0f;
+    if (turn < -180.0f) turn += 360.0f;
+
+    f32 from_scale = get_length(make_vector2(from._11, from._12));
+    f32 to_scale   = get_length(make_vector2(to._11,   to._12));
+
+    Vector2 position = make_vector2(lerp(from._31, step, to._31), lerp(from._32, step, to._32));
+    return make_transform2(position, from_orientation + (turn * step), lerp(from_scale, step, to_scale));
+}
+
+Matrix4 to_matrix4(Transform2 transform) {
+    Matrix4 matrix = make_identity_matrix();
+
+    matrix._11 = transform._11;
+    matrix._12 = transform._12;
+    matrix._21 = transform._21;
+    matrix._22 = transform._22;
+    matrix._41 = transform._31;
+    matrix._42 = transform._32;
+
+    return matrix;
+}
+
 // @note: This was lifted from the MESA implementation of the GLU library.
 Matrix4 make_inverse_matrix(Matrix4 matrix) {
     Matrix4 inverse;
@@ -0,0 +1,72 @@
+//
+// The null render backend for headless builds. It stands in for the part of OpenGL
+// the game uses so draw.cpp builds unchanged, but no call reaches a driver. Sprite
+// batching, text layout and the gui still do their CPU work, so a headless frame
+// costs what a real frame costs minus the driver and the gpu.
+//
+
+typedef u32 GLenum;
+typedef u32 GLbitfield;
+typedef u32 GLuint;
+typedef i32 GLint;
+typedef i32 GLsizei;
+typedef f32 GLfloat;
+typedef f32 GLclampf;
+typedef u8  GLboolean;
+typedef void GLvoid;
+
+#define GL_TRUE                 1
+#define GL_FLOAT                0x1406
+#define GL_UNSIGNED_BYTE        0x1401
+#define GL_LINE_LOOP            0x0002
+#define GL_QUADS                0x0007
+#define GL_BLEND                0x0BE2
+#define GL_SRC_ALPHA            0x0302
+#define GL_ONE_MINUS_SRC_ALPHA  0x0303
+#define GL_COLOR_BUFFER_BIT     0x4000
+#define GL_MODELVIEW            0x1700
+#define GL_PROJECTION           0x1701
+#define GL_TEXTURE_2D           0x0DE1
+#define GL_TEXTURE_MIN_FILTER   0x2801
+#define GL_LINEAR               0x2601
+#define GL_ALPHA                0x1906
+#define GL_RGBA                 0x1908
+#define GL_VERTEX_ARRAY         0x8074
+#define GL_COLOR_ARRAY          0x8076
+#define GL_TEXTURE_COORD_ARRAY  0x8078
+
+// @note: Texture names are still handed out so the sprite batch sorts and splits the same way
+GLuint null_gl_next_texture = 1;
+
+void glGenTextures(GLsizei count, GLuint* textures) {
+    for (GLsizei i = 0; i < count; i++) {
+        textures[i] = null_gl_next_texture++;
+    }
+}
+
+void glBindTexture(GLenum target, GLuint texture) {}
+void glTexImage2D(GLenum target, GLint level, GLint internal_format, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid* pixels) {}
+void glTexSubImage2D(GLenum target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid* pixels) {}
+void glTexParameteri(GLenum target, GLenum name, GLint value) {}
+
+void glEnable(GLenum capability) {}
+void glBlendFunc(GLenum source, GLenum destination) {}
+void glViewport(GLint x, GLint y, GLsizei width, GLsizei height) {}
+void glClearColor(GLclampf r, GLclampf g, GLclampf b, GLclampf a) {}
+void glClear(GLbitfield mask) {}
+
+void glMatrixMode(GLenum mode) {}
+void glLoadMatrixf(const GLfloat* matrix) {}
+
+void glBegin(GLenum mode) {}
+void glEnd() {}
+void glColor4f(GLfloat r, GLfloat g, GLfloat b, GLfloat a) {}
+void glTexCoord2f(GLfloat s, GLfloat t) {}
+void glVertex2f(GLfloat x, GLfloat y) {}
+
+void glEnableClientState(GLenum array) {}
+void glDisableClientState(GLenum array) {}
+void glVertexPointer(GLint size, GLenum type, GLsizei stride, const GLvoid* pointer) {}
+void glTexCoordPointer(GLint size, GLenum type, GLsizei stride, const GLvoid* pointer) {}
+void glColorPointer(GLint size, GLenum type, GLsizei stride, const GLvoid* pointer) {}
+void glDrawArrays(GLenum mode, GLint first, GLsizei count) {}
@@ -1,80 +1,174 @@
-struct Particle {
-    Vector2 position;
-    Vector2 velocity;
-    Vector2 acceleration;
-
-    f32 scale = 1.0f;
-    f32 opacity = 1.0f;
-
-    Sprite* sprite = null;
-    f32     size = 0.0f;
-
-    f32 lifetime = 0.0f;
-    bool is_alive = false;
+//
+// Particles live in a structure of arrays that only holds live particles. A particle
+// that dies is swapped with the last one and the arrays shrink, so the update and
+// draw passes only ever touch live particles and spawning never overwrites one.
+// The arrays grow when a spawn needs more room. The integration step runs four
+// particles at a time with SSE and finishes the remainder one at a time.
+//
+
+struct Particles {
+    Array<f32> position_x;
+    Array<f32> position_y;
+    Array<f32> velocity_x;
+    Array<f32> velocity_y;
+    Array<f32> acceleration_x;
+    Array<f32> acceleration_y;
+
+    Array<f32> scale;
+    Array<f32> opacity;
+    Array<f32> lifetime;
+
+    // @note: Index into sprite_smoke, which also sets the size
+    Array<u32> sprite_index;
 };
 
-Particle particles[1024];
-u32 next_particle = 0;
+Particles particles;
 
-void spawn_particles(Vector2 position, Vector2 velocity, f32 scale) {
-    u32 amount = get_random_between(5, 10);
-    for (u32 i = 0; i < amount; i++) {
-        Particle* particle = &particles[next_particle];
-        next_particle += 1;
+const u32 MAX_PARTICLES_PER_SPAWN  = 10;
+const u32 RANDOMS_PER_PARTICLE     = 8;
 
-        if (next_particle >= count_of(particles)) {
-            next_particle = 0;
-        }
+u32 get_particle_count() {
+    return particles.lifetime.count;
+}
 
-        particle->position = position;
-        particle->velocity = make_vector2(0.0f, 0.0f);
-        
-        particle->scale = scale;
-        particle->opacity = 1.0f;
+void remove_particle(u32 index) {
+    u32 last = get_particle_count() - 1;
+
+    particles.position_x[index]     = particles.position_x[last];
+    particles.position_y[index]     = particles.position_y[last];
+    particles.velocity_x[index]     = particles.velocity_x[last];
+    particles.velocity_y[index]     = particles.velocity_y[last];
+    particles.acceleration_x[index] = particles.acceleration_x[last];
+    particles.acceleration_y[index] = particles.acceleration_y[last];
+    particles.scale[index]          = particles.scale[last];
+    particles.opacity[index]        = particles.opacity[last];
+    particles.lifetime[index]       = particles.lifetime[last];
+    particles.sprite_index[index]   = particles.sprite_index[last];
+
+    particles.position_x.count     -= 1;
+    particles.position_y.count     -= 1;
+    particles.velocity_x.count     -= 1;
+    particles.velocity_y.count     -= 1;
+    particles.acceleration_x.count -= 1;
+    particles.acceleration_y.count -= 1;
+    particles.scale.count          -= 1;
+    particles.opacity.count        -= 1;
+    particles.lifetime.count       -= 1;
+    particles.sprite_index.count   -= 1;
+}
 
-        particle->position.x += get_random_between(-0.25f, 0.25f);
-        particle->position.y += get_random_between(-0.25f, 0.25f);
+void spawn_particles(Vector2 position, Vector2 velocity, f32 scale) {
+    u32 amount = get_random_between(&particles_random, 5, MAX_PARTICLES_PER_SPAWN);
 
-        particle->velocity.x += get_random_between(-0.5f, 0.5f);
-        particle->velocity.y += get_random_between(-0.5f, 0.5f);
-        
-        particle->acceleration.x = get_random_between(-0.25f, 0.25f);
-        particle->acceleration.y = get_random_between(-0.25f, 0.25f);
+    // @note: Draw every random number the spawn needs in one go
+    f32 randoms[MAX_PARTICLES_PER_SPAWN * RANDOMS_PER_PARTICLE];
+    get_random_unilaterals(&particles_random, randoms, amount * RANDOMS_PER_PARTICLE);
 
-        u32 index = get_random_out_of(9);
-        
-        particle->sprite = &sprite_smoke[index];
-        particle->size   = index / 10.0f;
+    Heap_Tag previous_tag = set_heap_tag(HEAP_TAG_PARTICLES);
 
-        particle->lifetime = get_random_between(0.25f, 0.75f);
-        particle->is_alive = true;
+    for (u32 i = 0; i < amount; i++) {
+        f32* random = &randoms[i * RANDOMS_PER_PARTICLE];
+
+        u32 index = (u32) (random[6] * 9.0f);
+
+        add(&particles.position_x,     position.x + lerp(-0.25f, random[0], 0.25f));
+        add(&particles.position_y,     position.y + lerp(-0.25f, random[1], 0.25f));
+        add(&particles.velocity_x,     lerp(-0.5f, random[2], 0.5f));
+        add(&particles.velocity_y,     lerp(-0.5f, random[3], 0.5f));
+        add(&particles.acceleration_x, lerp(-0.25f, random[4], 0.25f));
+        add(&particles.acceleration_y, lerp(-0.25f, random[5], 0.25f));
+        add(&particles.scale,          scale);
+        add(&particles.opacity,        1.0f);
+        add(&particles.lifetime,       lerp(0.25f, random[7], 0.75f));
+        add(&particles.sprite_index,   index);
     }
+
+    set_heap_tag(previous_tag);
 }
 
 void update_particles() {
-    for (u32 i = 0; i < count_of(particles); i++) {
-        Particle* particle = &particles[i];
-        if (!particle->is_alive) continue;
+    u32 count = get_particle_count();
+    f32 delta = timers.tick_delta;
+
+    f32* position_x     = particles.position_x.elements;
+    f32* position_y     = particles.position_y.elements;
+    f32* velocity_x     = particles.velocity_x.elements;
+    f32* velocity_y     = particles.velocity_y.elements;
+    f32* acceleration_x = particles.acceleration_x.elements;
+    f32* acceleration_y = particles.acceleration_y.elements;
+    f32* scale          = particles.scale.elements;
+    f32* opacity        = particles.opacity.elements;
+    f32* lifetime       = particles.lifetime.elements;
+
+    // @note: The scale and opacity ease toward zero by lerp(value, delta, 0)
+    f32 half_delta_squared = 0.5f * square(delta);
+    f32 decay              = 1.0f - delta;
+
+    __m128 delta_4              = _mm_set1_ps(delta);
+    __m128 half_delta_squared_4 = _mm_set1_ps(half_delta_squared);
+    __m128 decay_4              = _mm_set1_ps(decay);
+
+    u32 i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 velocity_x_4     = _mm_loadu_ps(&velocity_x[i]);
+        __m128 velocity_y_4     = _mm_loadu_ps(&velocity_y[i]);
+        __m128 acceleration_x_4 = _mm_loadu_ps(&acceleration_x[i]);
+        __m128 acceleration_y_4 = _mm_loadu_ps(&acceleration_y[i]);
+
+        __m128 step_x = _mm_add_ps(_mm_mul_ps(half_delta_squared_4, acceleration_x_4), _mm_mul_ps(delta_4, velocity_x_4));
+        __m128 step_y = _mm_add_ps(_mm_mul_ps(half_delta_squared_4, acceleration_y_4), _mm_mul_ps(delta_4, velocity_y_4));
+
+        _mm_storeu_ps(&position_x[i], _mm_add_ps(_mm_loadu_ps(&position_x[i]), step_x));
+        _mm_storeu_ps(&position_y[i], _mm_add_ps(_mm_loadu_ps(&position_y[i]), step_y));
+
+        _mm_storeu_ps(&velocity_x[i], _mm_add_ps(velocity_x_4, _mm_mul_ps(delta_4, acceleration_x_4)));
+        _mm_storeu_ps(&velocity_y[i], _mm_add_ps(velocity_y_4, _mm_mul_ps(delta_4, acceleration_y_4)));
+
+        _mm_storeu_ps(&scale[i],    _mm_mul_ps(_mm_loadu_ps(&scale[i]),    decay_4));
+        _mm_storeu_ps(&opacity[i],  _mm_mul_ps(_mm_loadu_ps(&opacity[i]),  decay_4));
+        _mm_storeu_ps(&lifetime[i], _mm_sub_ps(_mm_loadu_ps(&lifetime[i]), delta_4));
+    }
 
-        if ((particle->lifetime -= timers.delta) <= 0.0f) {
-            particle->is_alive = false;
-            continue;
-        }
+    for (; i < count; i++) {
+        position_x[i] += (half_delta_squared * acceleration_x[i]) + (delta * velocity_x[i]);
+        position_y[i] += (half_delta_squared * acceleration_y[i]) + (delta * velocity_y[i]);
 
-        particle->position += (0.5f * square(timers.delta) * particle->acceleration) + (timers.delta * particle->velocity);
-        particle->velocity += timers.delta * particle->acceleration;
+        velocity_x[i] += delta * acceleration_x[i];
+        velocity_y[i] += delta * acceleration_y[i];
 
-        particle->scale = lerp(particle->scale, timers.delta, 0.0f);
-        particle->opacity = lerp(particle->opacity, timers.delta, 0.0f);
+        scale[i]    *= decay;
+        opacity[i]  *= decay;
+        lifetime[i] -= delta;
+    }
+
+    // @note: The particle swapped into a dead one's slot is checked before moving on
+    i = 0;
+
+    while (i < get_particle_count()) {
+        if (particles.lifetime[i] <= 0.0f) {
+            remove_particle(i);
+        }
+        else {
+            i += 1;
+        }
     }
 }
 
 void draw_particles() {
-    for (u32 i = 0; i < count_of(particles); i++) {
-        Particle* particle = &particles[i];
-        if (!particle->is_alive) continue;
+    Array<Sprite_Instance> instances;
+    instances.allocator = &temp_allocator;
+
+    allocate(&instances, get_particle_count());
+
+    for (u32 i = 0; i < get_particle_count(); i++) {
+        Sprite_Instance* instance = next(&instances);
 
-        set_transform(make_transform_matrix(particle->position, 0.0f, particle->scale));
-        draw_sprite(particle->sprite, particle->size, particle->opacity);
+        instance->position = make_vector2(particles.position_x[i], particles.position_y[i]);
+        instance->size     = (particles.sprite_index[i] / 10.0f) * particles.scale[i];
+        instance->opacity  = particles.opacity[i];
+        instance->sprite   = particles.sprite_index[i];
     }
-}
\ No newline at end of file
+
+    draw_sprite_instances(sprite_smoke, &instances);
+}
@@ -11,10 +11,14 @@
 
     #include <windows.h>
     #include <windowsx.h>
-    #include <gl/gl.h>
+    #include <intrin.h>
     // #include <xinput.h>
     #include <xaudio2.h>
 
+    #if !HEADLESS
+        #include <gl/gl.h>
+    #endif
+
     #pragma comment(lib, "user32.lib")
     #pragma comment(lib, "gdi32.lib")
     #pragma comment(lib, "opengl32.lib")
@@ -24,15 +28,22 @@
     #pragma GCC diagnostic ignored "-Wwrite-strings"
     #pragma GCC diagnostic ignored "-Wformat-security"
 
-    #define Time __Time
-    #define Font __Font
-    
-    #include <X11/Xlib.h>
-    #include <GL/gl.h>
-    #include <GL/glx.h>
+    #if !HEADLESS
+        #define Time __Time
+        #define Font __Font
+        
+        #include <X11/Xlib.h>
+        #include <GL/gl.h>
+        #include <GL/glx.h>
 
-    #undef Time
-    #undef Font
+        #undef Time
+        #undef Font
+    #endif
+
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <pthread.h>
+    #include <semaphore.h>
 #else
     #error "Unrecognized platform"
 #endif
@@ -42,6 +53,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <time.h>
+#include <string.h>
+#include <xmmintrin.h>
 
 typedef uint8_t  u8;
 typedef uint16_t u16;
@@ -63,11 +76,72 @@ typedef u32      utf32;
 #define count_of(array)         (size_of(array) / size_of(array[0]))
 #define offset_of(type, member) ((u32) ((type*) null)->member)
 
+#if OS_WINDOWS
+    #define thread_local_storage __declspec(thread)
+#elif OS_LINUX
+    #define thread_local_storage __thread
+#endif
+
+#if HEADLESS
+    #include "null_gl.cpp"
+#endif
+
 u32 to_u32(void* address) {
     return (u32)(u64) address;
 }
 
-const u32 TEMP_MEMORY_SIZE = 512 * 1024;
+// @note: Returns the new value, pass an addend of zero to read the value with a barrier
+u32 atomic_add(volatile u32* value, i32 addend) {
+    #if OS_WINDOWS
+        return (u32) InterlockedExchangeAdd((volatile LONG*) value, addend) + addend;
+    #elif OS_LINUX
+        return __sync_add_and_fetch(value, addend);
+    #endif
+}
+
+void acquire_spin_lock(volatile u32* lock) {
+    #if OS_WINDOWS
+        while (InterlockedExchange((volatile LONG*) lock, 1)) YieldProcessor();
+    #elif OS_LINUX
+        while (__sync_lock_test_and_set(lock, 1)) __builtin_ia32_pause();
+    #endif
+}
+
+void release_spin_lock(volatile u32* lock) {
+    #if OS_WINDOWS
+        InterlockedExchange((volatile LONG*) lock, 0);
+    #elif OS_LINUX
+        __sync_lock_release(lock);
+    #endif
+}
+
+// @note: The result is undefined when value is zero
+u32 count_trailing_zeros(u64 value) {
+    #if OS_WINDOWS
+        unsigned long result;
+        _BitScanForward64(&result, value);
+
+        return (u32) result;
+    #elif OS_LINUX
+        return (u32) __builtin_ctzll(value);
+    #endif
+}
+
+// @note: Every heap allocation is counted against the tag that was current when it
+// was made, see set_heap_tag
+enum Heap_Tag {
+    HEAP_TAG_GENERAL,
+    HEAP_TAG_ARENAS,
+    HEAP_TAG_ASSETS,
+    HEAP_TAG_FONTS,
+    HEAP_TAG_SOUND,
+    HEAP_TAG_ENTITIES,
+    HEAP_TAG_PARTICLES,
+    HEAP_TAG_COUNT
+};
+
+const u32 FRAME_ARENA_SIZE = 512 * 1024;
+const u32 MODE_ARENA_SIZE  = 64  * 1024;
 
 struct Platform {
     #if OS_WINDOWS
@@ -76,7 +150,7 @@ struct Platform {
         HDC             device_context;
         HGLRC           rendering_context;
         WINDOWPLACEMENT previous_window_placement = { size_of(previous_window_placement) };
-    #elif OS_LINUX
+    #elif OS_LINUX && !HEADLESS
         Display*   display;
         Window     window;
         GLXContext gl_context;
@@ -91,10 +165,14 @@ struct Platform {
 
     u32 heap_memory_allocated       = 0;
     u32 heap_memory_high_water_mark = 0;
+    u32 heap_memory_reserved        = 0;
+
+    u32 heap_memory_by_tag[HEAP_TAG_COUNT];
 
-    u8* temp_memory                 = null;
-    u32 temp_memory_allocated       = 0;
-    u32 temp_memory_high_water_mark = 0;
+    #if HEADLESS
+        u32 frame       = 0;
+        u32 frame_limit = 0;
+    #endif
 };
 
 Platform platform;
@@ -115,6 +193,14 @@ struct Timers {
 
     f32 now   = 0.0f;
     f32 delta = 0.0f;
+
+    // @note: The simulation advances in fixed ticks of tick_delta. The accumulator
+    // holds the frame time that hasn't been simulated yet and tick_interpolation is
+    // how far the frame is between the last two ticks, for rendering
+    f32 tick_delta         = 1.0f / 60.0f;
+    f32 tick_accumulator   = 0.0f;
+    f32 tick_interpolation = 0.0f;
+    u32 ticks              = 0;
 };
 
 Timers timers;
@@ -174,6 +260,129 @@ struct Input {
 
 Input input;
 
+//
+// The simulation reads tick_input instead of input. A frame can run zero or several
+// ticks, so the presses and releases of every frame are collected here until a tick
+// consumes them. Otherwise a click could be missed or fire twice.
+//
+
+Input tick_input;
+
+void merge_tick_key(Key* tick_key, Key* key) {
+    tick_key->up   |= key->up;
+    tick_key->down |= key->down;
+    tick_key->held  = key->held;
+}
+
+void accumulate_tick_input() {
+    #define merge(name) merge_tick_key(&tick_input.name, &input.name)
+
+    merge(mouse_left);
+    merge(mouse_right);
+    merge(key_escape);
+    merge(key_space);
+
+    merge(key_w);
+    merge(key_a);
+    merge(key_s);
+    merge(key_d);
+
+    merge(gamepad_start);
+    merge(gamepad_a);
+    merge(gamepad_b);
+    merge(gamepad_x);
+    merge(gamepad_y);
+
+    merge(gamepad_left_trigger);
+    merge(gamepad_right_trigger);
+
+    #undef merge
+
+    tick_input.mouse_x = input.mouse_x;
+    tick_input.mouse_y = input.mouse_y;
+
+    tick_input.gamepad_left_x  = input.gamepad_left_x;
+    tick_input.gamepad_left_y  = input.gamepad_left_y;
+    tick_input.gamepad_right_x = input.gamepad_right_x;
+    tick_input.gamepad_right_y = input.gamepad_right_y;
+}
+
+void consume_tick_input() {
+    #define consume(name) tick_input.name.up = false; tick_input.name.down = false
+
+    consume(mouse_left);
+    consume(mouse_right);
+    consume(key_escape);
+    consume(key_space);
+
+    consume(key_w);
+    consume(key_a);
+    consume(key_s);
+    consume(key_d);
+
+    consume(gamepad_start);
+    consume(gamepad_a);
+    consume(gamepad_b);
+    consume(gamepad_x);
+    consume(gamepad_y);
+
+    consume(gamepad_left_trigger);
+    consume(gamepad_right_trigger);
+
+    #undef consume
+}
+
+#if HEADLESS
+    //
+    // Headless builds have no window to read input from, so it comes from a script
+    // with one event per line. An event is the frame it happens on followed by a key
+    // and its new state, or the mouse and its new position:
+    //
+    //     120 space down
+    //     125 space up
+    //     300 mouse 800 450
+    //
+    // A key stays in the state the script last put it in. Frames have a fixed delta
+    // so a script plays out the same way every run.
+    //
+
+    const f32 HEADLESS_FRAME_DELTA = 1.0f / 60.0f;
+    const u32 MAX_SCRIPT_EVENTS    = 4096;
+
+    // @note: No member initializers, the table below is aggregate initialized
+    struct Script_Key {
+        utf8* name;
+        Key*  key;
+        bool  is_down;
+    };
+
+    Script_Key script_keys[] = {
+        { "mouse_left",  &input.mouse_left  },
+        { "mouse_right", &input.mouse_right },
+        { "escape",      &input.key_escape  },
+        { "space",       &input.key_space   },
+        { "w",           &input.key_w       },
+        { "a",           &input.key_a       },
+        { "s",           &input.key_s       },
+        { "d",           &input.key_d       }
+    };
+
+    struct Script_Event {
+        u32 frame = 0;
+
+        Script_Key* key     = null;
+        bool        is_down = false;
+
+        i32 mouse_x = 0;
+        i32 mouse_y = 0;
+    };
+
+    Script_Event script_events[MAX_SCRIPT_EVENTS];
+
+    u32 script_events_count = 0;
+    u32 next_script_event   = 0;
+#endif
+
 #if DEBUG
     #define assert(expression)                                              \
         do {                                                                \
@@ -216,10 +425,45 @@ u32 hash(utf8* string) {
     return hash;
 }
 
+const utf32 INVALID_CODEPOINT = 0xFFFD;
+
+// @note: Reads one codepoint and moves the cursor past it, bad sequences come back as INVALID_CODEPOINT
+utf32 decode_utf8(utf8** cursor) {
+    u8* bytes = (u8*) *cursor;
+
+    u32 length   = 1;
+    utf32 result = bytes[0];
+
+    if      ((bytes[0] & 0xE0) == 0xC0) { length = 2; result = bytes[0] & 0x1F; }
+    else if ((bytes[0] & 0xF0) == 0xE0) { length = 3; result = bytes[0] & 0x0F; }
+    else if ((bytes[0] & 0xF8) == 0xF0) { length = 4; result = bytes[0] & 0x07; }
+    else if (bytes[0] & 0x80) {
+        *cursor += 1;
+        return INVALID_CODEPOINT;
+    }
+
+    for (u32 i = 1; i < length; i++) {
+        if ((bytes[i] & 0xC0) != 0x80) {
+            *cursor += i;
+            return INVALID_CODEPOINT;
+        }
+
+        result = (result << 6) | (bytes[i] & 0x3F);
+    }
+
+    *cursor += length;
+    return result;
+}
+
 utf8* format_string_args(utf8* string, va_list args) {
     void* temp_alloc(u32 size);
 
-    u32 size = vsnprintf(null, 0, string, args);
+    // @note: The size query consumes the va_list on some platforms, so it gets its own copy
+    va_list size_args;
+    va_copy(size_args, args);
+
+    u32 size = vsnprintf(null, 0, string, size_args);
+    va_end(size_args);
 
     utf8* result = (utf8*) temp_alloc(size + 1);
     vsprintf(result, string, args);
@@ -238,8 +482,11 @@ utf8* format_string(utf8* string, ...) {
 }
 
 void __assert(utf8* file_name, u32 line_number, utf8* expression_string) {
-    utf8* message = format_string("Assertion failed at %s (%u), %s\n", file_name, line_number, expression_string);
-    printf(message);
+    // @note: Formatted on the stack, an assert can fail on a job thread or inside the arenas
+    utf8 message[1024];
+    snprintf(message, size_of(message), "Assertion failed at %s (%u), %s\n", file_name, line_number, expression_string);
+
+    printf("%s", message);
 
     #if OS_WINDOWS
         MessageBox(null, message, null, MB_OK | MB_ICONERROR);
@@ -252,81 +499,660 @@ void __assert(utf8* file_name, u32 line_number, utf8* expression_string) {
     exit(EXIT_FAILURE);
 }
 
-void* heap_alloc(u32 size) {
-    #if OS_WINDOWS
-        platform.heap_memory_allocated += size;
-        
-        if (platform.heap_memory_allocated > platform.heap_memory_high_water_mark) {
-            platform.heap_memory_high_water_mark = platform.heap_memory_allocated;
-        }
+utf8* to_string(Heap_Tag heap_tag) {
+    switch (heap_tag) {
+        case HEAP_TAG_GENERAL:   return "General";
+        case HEAP_TAG_ARENAS:    return "Arenas";
+        case HEAP_TAG_ASSETS:    return "Assets";
+        case HEAP_TAG_FONTS:     return "Fonts";
+        case HEAP_TAG_SOUND:     return "Sound";
+        case HEAP_TAG_ENTITIES:  return "Entities";
+        case HEAP_TAG_PARTICLES: return "Particles";
+        invalid_default_case();
+    }
 
-        void* result = HeapAlloc(platform.process_heap, 0, size);
-    #elif OS_LINUX
-        // @todo: Implement using mmap?
-        void* result = malloc(size);
-    #endif
+    return "Invalid";
+}
 
-    assert(result);
+//
+// Every heap allocation starts with a header holding its size and tag, so both
+// platforms keep the same accounting. On Windows the blocks come from the process
+// heap. On Linux small blocks come from size class pools carved out of mmap'd
+// regions and anything bigger than the largest class is mapped on its own.
+//
 
-    return result;
+struct Heap_Header {
+    u32 size = 0;
+    u32 tag  = 0;
+
+    // @note: The usable size of the block with the header, it decides how the block is freed
+    u32 capacity = 0;
+    u32 padding;
+};
+
+// @note: Each thread has its own current tag, so a job can't retag the main thread's allocations
+thread_local_storage Heap_Tag current_heap_tag = HEAP_TAG_GENERAL;
+volatile u32 heap_lock;
+
+Heap_Tag set_heap_tag(Heap_Tag tag) {
+    Heap_Tag previous_tag = current_heap_tag;
+    current_heap_tag = tag;
+
+    return previous_tag;
 }
 
-void heap_dealloc(void* memory) {
-    #if OS_WINDOWS
-        if (!memory) return;
-        assert(HeapValidate(platform.process_heap, 0, memory));
+void lock_heap() {
+    acquire_spin_lock(&heap_lock);
+}
+
+void unlock_heap() {
+    release_spin_lock(&heap_lock);
+}
+
+#if OS_LINUX
+    const u32 HEAP_SMALLEST_CLASS     = 32;
+    const u32 HEAP_SIZE_CLASS_COUNT   = 8;
+    const u32 HEAP_LARGEST_CLASS      = HEAP_SMALLEST_CLASS << (HEAP_SIZE_CLASS_COUNT - 1);
+    const u32 HEAP_POOL_REGION_SIZE   = 256 * 1024;
+    const u32 HEAP_PAGE_SIZE          = 4096;
+
+    struct Heap_Free_Slot {
+        Heap_Free_Slot* next;
+    };
+
+    struct Heap_Pool {
+        Heap_Free_Slot* free_slots;
+
+        u8* cursor;
+        u8* end;
+    };
+
+    Heap_Pool heap_pools[HEAP_SIZE_CLASS_COUNT];
+
+    u32 get_heap_size_class(u32 block_size) {
+        u32 size_class = 0;
+        while ((HEAP_SMALLEST_CLASS << size_class) < block_size) size_class += 1;
+
+        return size_class;
+    }
+
+    u32 round_up_to_pages(u32 size) {
+        return (size + HEAP_PAGE_SIZE - 1) & ~(HEAP_PAGE_SIZE - 1);
+    }
 
-        u32 size = (u32) HeapSize(platform.process_heap, 0, memory);
-        platform.heap_memory_allocated -= size;
+    void* map_pages(u32 size) {
+        void* result = mmap(null, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (result == MAP_FAILED) return null;
 
-        HeapFree(platform.process_heap, 0, memory);
+        platform.heap_memory_reserved += size;
+        return result;
+    }
+
+    void unmap_pages(void* memory, u32 size) {
+        munmap(memory, size);
+        platform.heap_memory_reserved -= size;
+    }
+#endif
+
+// @note: The usable size of a block, realloc grows in place up to it
+u32 get_heap_block_capacity(u32 block_size) {
+    #if OS_WINDOWS
+        return block_size;
     #elif OS_LINUX
-        free(memory);
+        if (block_size > HEAP_LARGEST_CLASS) return round_up_to_pages(block_size);
+        return HEAP_SMALLEST_CLASS << get_heap_size_class(block_size);
     #endif
 }
 
-void* heap_realloc(void* memory, u32 new_size) {
+void* allocate_heap_block(u32 block_size) {
     #if OS_WINDOWS
-        if (!memory) return heap_alloc(new_size);
-        assert(HeapValidate(platform.process_heap, 0, memory));
+        return HeapAlloc(platform.process_heap, 0, block_size);
+    #elif OS_LINUX
+        if (block_size > HEAP_LARGEST_CLASS) return map_pages(round_up_to_pages(block_size));
 
-        u32 old_size = (u32) HeapSize(platform.process_heap, 0, memory);
-        
-        platform.heap_memory_allocated -= old_size;
-        platform.heap_memory_allocated += new_size;
+        u32 size_class = get_heap_size_class(block_size);
+        u32 slot_size  = HEAP_SMALLEST_CLASS << size_class;
+
+        Heap_Pool* pool = &heap_pools[size_class];
+
+        if (pool->free_slots) {
+            Heap_Free_Slot* slot = pool->free_slots;
+            pool->free_slots = slot->next;
+
+            return slot;
+        }
+
+        if (pool->cursor + slot_size > pool->end) {
+            // @note: Regions are never unmapped, freed slots go back on the free list
+            pool->cursor = (u8*) map_pages(HEAP_POOL_REGION_SIZE);
+            if (!pool->cursor) return null;
+
+            pool->end = pool->cursor + HEAP_POOL_REGION_SIZE;
+        }
+
+        void* result = pool->cursor;
+        pool->cursor += slot_size;
+
+        return result;
+    #endif
+}
 
-        void* result = HeapReAlloc(platform.process_heap, 0, memory, new_size);
+void free_heap_block(void* block, u32 block_size) {
+    #if OS_WINDOWS
+        assert(HeapValidate(platform.process_heap, 0, block));
+        HeapFree(platform.process_heap, 0, block);
     #elif OS_LINUX
-        void* result = realloc(memory, new_size);
+        if (block_size > HEAP_LARGEST_CLASS) {
+            unmap_pages(block, round_up_to_pages(block_size));
+            return;
+        }
+
+        Heap_Pool* pool = &heap_pools[get_heap_size_class(block_size)];
+
+        Heap_Free_Slot* slot = (Heap_Free_Slot*) block;
+        slot->next = pool->free_slots;
+
+        pool->free_slots = slot;
     #endif
+}
+
+void count_heap_memory(Heap_Header* header, bool is_allocation) {
+    if (is_allocation) {
+        platform.heap_memory_allocated           += header->size;
+        platform.heap_memory_by_tag[header->tag] += header->size;
 
-    assert(result);
+        if (platform.heap_memory_allocated > platform.heap_memory_high_water_mark) {
+            platform.heap_memory_high_water_mark = platform.heap_memory_allocated;
+        }
+    }
+    else {
+        platform.heap_memory_allocated           -= header->size;
+        platform.heap_memory_by_tag[header->tag] -= header->size;
+    }
+}
+
+void* heap_alloc(u32 size) {
+    lock_heap();
+
+    u32 block_size = size_of(Heap_Header) + size;
+    Heap_Header* header = (Heap_Header*) allocate_heap_block(block_size);
     
+    if (header) {
+        header->size     = size;
+        header->tag      = current_heap_tag;
+        header->capacity = get_heap_block_capacity(block_size);
+
+        count_heap_memory(header, true);
+    }
+
+    unlock_heap();
+
+    assert(header);
+    return header + 1;
+}
+
+void heap_dealloc(void* memory) {
+    if (!memory) return;
+
+    Heap_Header* header = (Heap_Header*) memory - 1;
+
+    lock_heap();
+
+    count_heap_memory(header, false);
+    free_heap_block(header, header->capacity);
+
+    unlock_heap();
+}
+
+void* heap_realloc(void* memory, u32 new_size) {
+    if (!memory) return heap_alloc(new_size);
+
+    Heap_Header* header = (Heap_Header*) memory - 1;
+
+    // @note: Grow or shrink in place when the block already has room
+    if (size_of(Heap_Header) + new_size <= header->capacity) {
+        lock_heap();
+
+        count_heap_memory(header, false);
+        header->size = new_size;
+        count_heap_memory(header, true);
+
+        unlock_heap();
+        return memory;
+    }
+
+    u32 old_size = header->size;
+
+    // @note: The new block keeps the tag of the old one
+    Heap_Tag previous_tag = set_heap_tag((Heap_Tag) header->tag);
+    void* result = heap_alloc(new_size);
+    set_heap_tag(previous_tag);
+
+    memcpy(result, memory, old_size < new_size ? old_size : new_size);
+    heap_dealloc(memory);
+
     return result;
 }
 
-void* temp_alloc(u32 size) {
-    // @todo: Remove these from temp_alloc, this would be a recursive call because
-    // assert calls temp_alloc
-    // Need to hardcode something for temp alloc that is special, I think
+//
+// Arenas are bump allocators made of a chain of blocks. When the current block
+// runs out a bigger one is chained on instead of failing, and the next reset
+// replaces the chain with a single block big enough for the peak, so an arena
+// settles at the size its worst frame needs.
+//
+// A mark remembers where an arena was so everything allocated after it can be
+// given back at once with pop_arena_mark. A named mark also records the peak
+// memory used inside it, which the debug overlay shows per scope.
+//
+// There is a frame arena behind temp_alloc that is reset every frame and a mode
+// arena that is reset whenever the game mode changes. Both belong to the main
+// thread. Entity update jobs don't need scratch memory, they queue their commands
+// in their Update_Job's arrays, which are kept across ticks.
+//
+
+const u32 ARENA_ALIGNMENT       = 8;
+const u32 MAX_ARENA_SCOPE_STATS = 32;
+
+struct Arena_Block {
+    Arena_Block* previous = null;
+
+    u32 size = 0;
+    u32 used = 0;
+};
+
+struct Arena {
+    utf8* name = null;
+
+    Arena_Block* block      = null;
+    u32          block_size = 0;
+    u32          blocks     = 0;
+
+    u32 allocated       = 0;
+    u32 high_water_mark = 0;
+    u32 scope_peak      = 0;
+};
+
+struct Arena_Mark {
+    Arena* arena = null;
+    utf8*  name  = null;
+
+    Arena_Block* block = null;
+    u32 used       = 0;
+    u32 allocated  = 0;
+    u32 scope_peak = 0;
+};
+
+struct Arena_Scope_Stats {
+    Arena* arena = null;
+    utf8*  name  = null;
+
+    u32 last_peak = 0;
+    u32 peak      = 0;
+};
+
+Arena frame_arena;
+Arena mode_arena;
+
+// @note: Set on the job threads so arena use from a job is caught
+thread_local_storage bool is_job_thread = false;
+
+Arena_Scope_Stats arena_scope_stats[MAX_ARENA_SCOPE_STATS];
+u32 arena_scope_stats_count;
+
+u8* get_block_memory(Arena_Block* block) {
+    return (u8*) block + ((size_of(Arena_Block) + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1));
+}
+
+Arena_Block* make_arena_block(u32 size) {
+    u32 header_size = (size_of(Arena_Block) + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
     
-    assert(platform.temp_memory);
-    assert(platform.temp_memory_allocated + size <= TEMP_MEMORY_SIZE);
+    Heap_Tag previous_tag = set_heap_tag(HEAP_TAG_ARENAS);
+    Arena_Block* block = (Arena_Block*) heap_alloc(header_size + size);
+    set_heap_tag(previous_tag);
+
+    block->previous = null;
+    block->size     = size;
+    block->used     = 0;
+
+    return block;
+}
+
+Arena make_arena(utf8* name, u32 block_size) {
+    Arena arena;
 
-    void* result = platform.temp_memory + platform.temp_memory_allocated;
-    platform.temp_memory_allocated += size;
+    arena.name       = name;
+    arena.block_size = block_size;
+    arena.block      = make_arena_block(block_size);
+    arena.blocks     = 1;
+
+    return arena;
+}
 
-    if (platform.temp_memory_allocated > platform.temp_memory_high_water_mark) {
-        platform.temp_memory_high_water_mark = platform.temp_memory_allocated;
+void* arena_alloc(Arena* arena, u32 size) {
+    assert(!is_job_thread);
+
+    u32 aligned_size = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+
+    Arena_Block* block = arena->block;
+    if (!block || block->used + aligned_size > block->size) {
+        u32 new_block_size = arena->block_size > aligned_size ? arena->block_size : aligned_size;
+        
+        Arena_Block* new_block = make_arena_block(new_block_size);
+        new_block->previous = block;
+
+        arena->block   = new_block;
+        arena->blocks += 1;
+
+        block = new_block;
     }
 
+    void* result = get_block_memory(block) + block->used;
+    block->used += aligned_size;
+
+    arena->allocated += aligned_size;
+
+    if (arena->allocated > arena->high_water_mark) arena->high_water_mark = arena->allocated;
+    if (arena->allocated > arena->scope_peak)      arena->scope_peak      = arena->allocated;
+
     return result;
 }
 
+void free_arena_blocks(Arena* arena, Arena_Block* until) {
+    while (arena->block != until) {
+        Arena_Block* previous = arena->block->previous;
+        heap_dealloc(arena->block);
+
+        arena->block   = previous;
+        arena->blocks -= 1;
+    }
+}
+
+void reset_arena(Arena* arena) {
+    // @note: The arena overflowed since it was sized, so replace the chain with one
+    // block that fits the peak
+    if (arena->blocks > 1 || arena->high_water_mark > arena->block_size) {
+        free_arena_blocks(arena, null);
+
+        if (arena->high_water_mark > arena->block_size) {
+            arena->block_size = arena->high_water_mark;
+        }
+
+        arena->block  = make_arena_block(arena->block_size);
+        arena->blocks = 1;
+    }
+
+    if (arena->block) arena->block->used = 0;
+
+    arena->allocated  = 0;
+    arena->scope_peak = 0;
+}
+
+Arena_Mark push_arena_mark(Arena* arena, utf8* name = null) {
+    Arena_Mark mark;
+
+    mark.arena      = arena;
+    mark.name       = name;
+    mark.block      = arena->block;
+    mark.used       = arena->block ? arena->block->used : 0;
+    mark.allocated  = arena->allocated;
+    mark.scope_peak = arena->scope_peak;
+
+    arena->scope_peak = arena->allocated;
+    return mark;
+}
+
+void record_arena_scope(Arena_Mark mark, u32 peak) {
+    Arena_Scope_Stats* stats = null;
+
+    for (u32 i = 0; i < arena_scope_stats_count; i++) {
+        if (arena_scope_stats[i].arena == mark.arena && compare(arena_scope_stats[i].name, mark.name)) {
+            stats = &arena_scope_stats[i];
+            break;
+        }
+    }
+
+    if (!stats) {
+        if (arena_scope_stats_count == MAX_ARENA_SCOPE_STATS) return;
+
+        stats = &arena_scope_stats[arena_scope_stats_count++];
+        stats->arena = mark.arena;
+        stats->name  = mark.name;
+    }
+
+    stats->last_peak = peak;
+    if (peak > stats->peak) stats->peak = peak;
+}
+
+void pop_arena_mark(Arena_Mark mark) {
+    Arena* arena = mark.arena;
+
+    u32 peak = arena->scope_peak - mark.allocated;
+    if (mark.name) record_arena_scope(mark, peak);
+
+    // @note: Blocks chained on inside the scope are given back, the parent scope
+    // still saw the peak
+    free_arena_blocks(arena, mark.block);
+
+    if (arena->block) arena->block->used = mark.used;
+    arena->allocated = mark.allocated;
+
+    arena->scope_peak = mark.scope_peak > arena->scope_peak ? mark.scope_peak : arena->scope_peak;
+}
+
+void* temp_alloc(u32 size) {
+    return arena_alloc(&frame_arena, size);
+}
+
 void temp_dealloc(void* memory) {
     
 }
 
+//
+// The job system runs a batch of jobs across a pool of worker threads and the
+// calling thread. A batch is dealt out round robin into a queue per thread, every
+// thread takes from the back of its own queue and steals from the front of the
+// others once its own is empty, and run_jobs returns when the whole batch is done.
+// The workers sleep on a semaphore between batches.
+//
+// Jobs run in any order on any thread, so a job must only write state that no other
+// job in the batch touches. The frame and mode arenas are not thread safe, jobs
+// must not allocate from them.
+//
+
+const u32 MAX_JOB_THREADS = 16;
+const u32 MAX_QUEUED_JOBS = 256;
+
+typedef void Job_Proc(void* data, u32 job_index);
+
+struct Job {
+    Job_Proc* proc = null;
+    void*     data = null;
+
+    u32 index = 0;
+};
+
+struct Job_Queue {
+    volatile u32 lock;
+
+    Job jobs[MAX_QUEUED_JOBS];
+
+    u32 front;
+    u32 back;
+};
+
+struct Job_System {
+    u32 thread_count = 1;
+    Job_Queue queues[MAX_JOB_THREADS];
+
+    volatile u32 jobs_remaining;
+
+    #if OS_WINDOWS
+        HANDLE wake_semaphore;
+    #elif OS_LINUX
+        sem_t wake_semaphore;
+    #endif
+};
+
+Job_System job_system;
+
+void push_job(Job_Queue* queue, Job job) {
+    acquire_spin_lock(&queue->lock);
+
+    assert(queue->back - queue->front < MAX_QUEUED_JOBS);
+    queue->jobs[queue->back % MAX_QUEUED_JOBS] = job;
+    queue->back += 1;
+
+    release_spin_lock(&queue->lock);
+}
+
+bool take_job(u32 thread_index, Job* job) {
+    bool result = false;
+
+    for (u32 i = 0; i < job_system.thread_count && !result; i++) {
+        Job_Queue* queue = &job_system.queues[(thread_index + i) % job_system.thread_count];
+        acquire_spin_lock(&queue->lock);
+
+        if (queue->front != queue->back) {
+            if (i == 0) {
+                queue->back -= 1;
+                *job = queue->jobs[queue->back % MAX_QUEUED_JOBS];
+            }
+            else {
+                *job = queue->jobs[queue->front % MAX_QUEUED_JOBS];
+                queue->front += 1;
+            }
+
+            result = true;
+        }
+
+        release_spin_lock(&queue->lock);
+    }
+
+    return result;
+}
+
+bool run_next_job(u32 thread_index) {
+    Job job;
+    if (!take_job(thread_index, &job)) return false;
+
+    job.proc(job.data, job.index);
+    atomic_add(&job_system.jobs_remaining, -1);
+
+    return true;
+}
+
+#if OS_WINDOWS
+    DWORD WINAPI job_thread_proc(LPVOID parameter) {
+        u32 thread_index = (u32) (u64) parameter;
+        is_job_thread = true;
+
+        while (true) {
+            WaitForSingleObject(job_system.wake_semaphore, INFINITE);
+            while (run_next_job(thread_index));
+        }
+
+        return 0;
+    }
+#elif OS_LINUX
+    void* job_thread_proc(void* parameter) {
+        u32 thread_index = (u32) (u64) parameter;
+        is_job_thread = true;
+
+        while (true) {
+            sem_wait(&job_system.wake_semaphore);
+            while (run_next_job(thread_index));
+        }
+
+        return null;
+    }
+#endif
+
+u32 get_processor_count() {
+    #if OS_WINDOWS
+        SYSTEM_INFO system_info;
+        GetSystemInfo(&system_info);
+
+        return system_info.dwNumberOfProcessors;
+    #elif OS_LINUX
+        i64 processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+        return processor_count > 0 ? (u32) processor_count : 1;
+    #endif
+}
+
+// @note: The thread count includes the calling thread, pass zero to use one thread per processor
+void init_job_system(u32 thread_count) {
+    if (!thread_count) thread_count = get_processor_count();
+
+    if (thread_count > MAX_JOB_THREADS) thread_count = MAX_JOB_THREADS;
+    job_system.thread_count = thread_count;
+
+    #if OS_WINDOWS
+        job_system.wake_semaphore = CreateSemaphoreA(null, 0, MAX_QUEUED_JOBS * MAX_JOB_THREADS, null);
+    #elif OS_LINUX
+        sem_init(&job_system.wake_semaphore, 0, 0);
+    #endif
+
+    for (u32 i = 1; i < job_system.thread_count; i++) {
+        #if OS_WINDOWS
+            HANDLE thread = CreateThread(null, 0, job_thread_proc, (LPVOID) (u64) i, 0, null);
+            assert(thread);
+
+            CloseHandle(thread);
+        #elif OS_LINUX
+            pthread_t thread;
+            i32 result = pthread_create(&thread, null, job_thread_proc, (void*) (u64) i);
+            assert(result == 0);
+
+            pthread_detach(thread);
+        #endif
+    }
+
+    printf("Started the job system with %u threads\n", job_system.thread_count);
+}
+
+void run_jobs(Job_Proc* proc, void* data, u32 job_count) {
+    if (job_system.thread_count == 1 || job_count < 2) {
+        for (u32 i = 0; i < job_count; i++) {
+            proc(data, i);
+        }
+
+        return;
+    }
+
+    atomic_add(&job_system.jobs_remaining, job_count);
+
+    for (u32 i = 0; i < job_count; i++) {
+        Job job;
+
+        job.proc  = proc;
+        job.data  = data;
+        job.index = i;
+
+        push_job(&job_system.queues[i % job_system.thread_count], job);
+    }
+
+    u32 wake_count = job_count - 1 < job_system.thread_count - 1 ? job_count - 1 : job_system.thread_count - 1;
+
+    #if OS_WINDOWS
+        ReleaseSemaphore(job_system.wake_semaphore, wake_count, null);
+    #elif OS_LINUX
+        for (u32 i = 0; i < wake_count; i++) {
+            sem_post(&job_system.wake_semaphore);
+        }
+    #endif
+
+    // @note: The calling thread works through the batch too and then waits on whatever is still running
+    while (atomic_add(&job_system.jobs_remaining, 0)) {
+        if (!run_next_job(0)) {
+            #if OS_WINDOWS
+                YieldProcessor();
+            #elif OS_LINUX
+                __builtin_ia32_pause();
+            #endif
+        }
+    }
+}
+
 // @todo: Implement natively
 void* read_entire_file(utf8* file_name) {
     void* result = null;
@@ -348,15 +1174,27 @@ void* read_entire_file(utf8* file_name) {
 }
 
 utf8* get_executable_directory() {
-    utf8 buffer[MAX_PATH];
-    u32 length = GetModuleFileName(GetModuleHandle(null), buffer, count_of(buffer));
+    #if OS_WINDOWS
+        utf8 buffer[MAX_PATH];
+        u32 length = GetModuleFileName(GetModuleHandle(null), buffer, count_of(buffer));
+
+        utf32 separator = '\\';
+    #elif OS_LINUX
+        utf8 buffer[4096];
+
+        ssize_t read_length = readlink("/proc/self/exe", buffer, count_of(buffer) - 1);
+        u32 length = read_length > 0 ? (u32) read_length : 0;
+
+        buffer[length] = null;
+        utf32 separator = '/';
+    #endif
 
     utf8* cursor = &buffer[length];
     while (cursor > buffer) {
         utf32 codepoint = *cursor;
         *cursor = null;
 
-        if (codepoint == '\\') break;
+        if (codepoint == separator) break;
         cursor -= 1;
     }
 
@@ -370,41 +1208,67 @@ utf8* get_executable_directory() {
 }
 
 void toggle_fullscreen() {
-    DWORD style = GetWindowLong(platform.window, GWL_STYLE);
-    if (style & WS_OVERLAPPEDWINDOW) {
-        GetWindowPlacement(platform.window, &platform.previous_window_placement);
-
-        MONITORINFO monitor_info = { size_of(monitor_info) };
-        GetMonitorInfo(MonitorFromWindow(platform.window, MONITOR_DEFAULTTOPRIMARY), &monitor_info);
-
-        SetWindowLong(platform.window, GWL_STYLE, style & ~WS_OVERLAPPEDWINDOW);
-
-        SetWindowPos(
-            platform.window, 
-            HWND_TOP, 
-            monitor_info.rcMonitor.left, 
-            monitor_info.rcMonitor.top, 
-            monitor_info.rcMonitor.right  - monitor_info.rcMonitor.left, 
-            monitor_info.rcMonitor.bottom - monitor_info.rcMonitor.top, 
-            SWP_NOOWNERZORDER | SWP_FRAMECHANGED);
-
-        platform.is_fullscreen = true;
-    }
-    else {
-        SetWindowLong(platform.window, GWL_STYLE, style | WS_OVERLAPPEDWINDOW);
-        SetWindowPlacement(platform.window, &platform.previous_window_placement);
-
-        SetWindowPos(
-            platform.window, 
-            null, 
-            0, 
-            0, 
-            0, 
-            0, 
-            SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_FRAMECHANGED);
+    #if HEADLESS
+        platform.is_fullscreen = !platform.is_fullscreen;
+    #elif OS_WINDOWS
+        DWORD style = GetWindowLong(platform.window, GWL_STYLE);
+        if (style & WS_OVERLAPPEDWINDOW) {
+            GetWindowPlacement(platform.window, &platform.previous_window_placement);
+
+            MONITORINFO monitor_info = { size_of(monitor_info) };
+            GetMonitorInfo(MonitorFromWindow(platform.window, MONITOR_DEFAULTTOPRIMARY), &monitor_info);
+
+            SetWindowLong(platform.window, GWL_STYLE, style & ~WS_OVERLAPPEDWINDOW);
+
+            SetWindowPos(
+                platform.window, 
+                HWND_TOP, 
+                monitor_info.rcMonitor.left, 
+                monitor_info.rcMonitor.top, 
+                monitor_info.rcMonitor.right  - monitor_info.rcMonitor.left, 
+                monitor_info.rcMonitor.bottom - monitor_info.rcMonitor.top, 
+                SWP_NOOWNERZORDER | SWP_FRAMECHANGED);
+
+            platform.is_fullscreen = true;
+        }
+        else {
+            SetWindowLong(platform.window, GWL_STYLE, style | WS_OVERLAPPEDWINDOW);
+            SetWindowPlacement(platform.window, &platform.previous_window_placement);
+
+            SetWindowPos(
+                platform.window, 
+                null, 
+                0, 
+                0, 
+                0, 
+                0, 
+                SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_FRAMECHANGED);
+
+            platform.is_fullscreen = false;
+        }
+    #elif OS_LINUX
+        // @note: The window manager owns the fullscreen state, so we ask the root window for it.
+        XEvent event = {};
+
+        event.type                 = ClientMessage;
+        event.xclient.window       = platform.window;
+        event.xclient.message_type = XInternAtom(platform.display, "_NET_WM_STATE", False);
+        event.xclient.format       = 32;
+        event.xclient.data.l[0]    = platform.is_fullscreen ? 0 : 1; // _NET_WM_STATE_REMOVE or _NET_WM_STATE_ADD.
+        event.xclient.data.l[1]    = XInternAtom(platform.display, "_NET_WM_STATE_FULLSCREEN", False);
+        event.xclient.data.l[2]    = 0;
+        event.xclient.data.l[3]    = 1; // Source indication: normal application.
+
+        XSendEvent(
+            platform.display, 
+            DefaultRootWindow(platform.display), 
+            False, 
+            SubstructureRedirectMask | SubstructureNotifyMask, 
+            &event);
+        XFlush(platform.display);
 
-        platform.is_fullscreen = false;
-    }
+        platform.is_fullscreen = !platform.is_fullscreen;
+    #endif
 }
 
 #if OS_WINDOWS
@@ -490,14 +1354,321 @@ f64 timespec_to_f64(timespec time) {
 
 #endif
 
+f64 get_wall_clock() {
+    #if OS_WINDOWS
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+
+        LARGE_INTEGER ticks;
+        QueryPerformanceCounter(&ticks);
+
+        return (f64) ticks.QuadPart / (f64) frequency.QuadPart;
+    #elif OS_LINUX
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        return timespec_to_f64(now);
+    #endif
+}
+
+#if HEADLESS
+
+bool load_input_script(utf8* file_name) {
+    FILE* script_file = fopen(file_name, "rb");
+    if (!script_file) {
+        printf("Failed to load input script '%s'\n", file_name);
+        return false;
+    }
+
+    script_events_count = 0;
+    next_script_event   = 0;
+
+    u32  frame;
+    utf8 name[32];
+
+    while (fscanf(script_file, "%u %31s", &frame, name) == 2) {
+        if (script_events_count == MAX_SCRIPT_EVENTS) {
+            printf("Input script '%s' has more than %u events\n", file_name, MAX_SCRIPT_EVENTS);
+            break;
+        }
+
+        Script_Event event;
+        event.frame = frame;
+
+        if (compare(name, "mouse")) {
+            fscanf(script_file, "%d %d", &event.mouse_x, &event.mouse_y);
+        }
+        else {
+            for (u32 i = 0; i < count_of(script_keys); i++) {
+                if (compare(name, script_keys[i].name)) event.key = &script_keys[i];
+            }
+
+            utf8 state[8];
+            fscanf(script_file, "%7s", state);
+
+            if (!event.key) {
+                printf("Unknown key '%s' in input script '%s'\n", name, file_name);
+                continue;
+            }
+
+            event.is_down = compare(state, "down");
+        }
+
+        // @note: Events are applied in frame order, keep the file order for events on the same frame
+        u32 index = script_events_count;
+        while (index > 0 && script_events[index - 1].frame > event.frame) {
+            script_events[index] = script_events[index - 1];
+            index -= 1;
+        }
+
+        script_events[index] = event;
+        script_events_count += 1;
+    }
+
+    fclose(script_file);
+    printf("Loaded input script '%s' (%u events)\n", file_name, script_events_count);
+
+    return true;
+}
+
+void apply_input_script(u32 frame) {
+    while (next_script_event < script_events_count && script_events[next_script_event].frame <= frame) {
+        Script_Event* event = &script_events[next_script_event];
+
+        if (event->key) {
+            event->key->is_down = event->is_down;
+        }
+        else {
+            input.mouse_x = event->mouse_x;
+            input.mouse_y = event->mouse_y;
+        }
+
+        next_script_event += 1;
+    }
+
+    for (u32 i = 0; i < count_of(script_keys); i++) {
+        update_key(script_keys[i].key, script_keys[i].is_down);
+    }
+}
+
+#endif
+
+//
+// A recording stores what update_platform produced each frame: the frame delta,
+// the window size and the state of the input. Replaying it feeds the same frames
+// back, and together with the seed and tick rate in the header the game plays out
+// exactly as it did, which makes a recorded session a repeatable benchmark.
+//
+
+const u32 RECORDING_MAGIC   = 0x52545341; // "ASTR"
+const u32 RECORDING_VERSION = 2;
+
+struct Recording_Header {
+    u32 magic       = RECORDING_MAGIC;
+    u32 version     = RECORDING_VERSION;
+    u64 seed        = 0;
+    u32 tick_rate   = 0;
+    u32 start_mode  = 0;
+    u32 frame_count = 0;
+    u32 padding     = 0;
+};
+
+struct Recorded_Frame {
+    f32 now   = 0.0f;
+    f32 delta = 0.0f;
+
+    u16 window_width  = 0;
+    u16 window_height = 0;
+
+    // @note: Stored as they were rather than rebuilt by update_key, which already ran on the live input
+    u32 held_keys = 0;
+    u32 down_keys = 0;
+    u32 up_keys   = 0;
+
+    i32 mouse_x = 0;
+    i32 mouse_y = 0;
+
+    f32 gamepad_left_x  = 0.0f;
+    f32 gamepad_left_y  = 0.0f;
+    f32 gamepad_right_x = 0.0f;
+    f32 gamepad_right_y = 0.0f;
+};
+
+enum Recording_Mode {
+    RECORDING_MODE_NONE,
+    RECORDING_MODE_RECORD,
+    RECORDING_MODE_REPLAY
+};
+
+struct Recording {
+    Recording_Mode mode = RECORDING_MODE_NONE;
+
+    FILE*            file = null;
+    Recording_Header header;
+    u32              frame = 0;
+};
+
+Recording recording;
+
+Key* recorded_keys[] = {
+    &input.mouse_left,
+    &input.mouse_right,
+    &input.key_escape,
+    &input.key_space,
+    &input.key_w,
+    &input.key_a,
+    &input.key_s,
+    &input.key_d,
+    &input.gamepad_start,
+    &input.gamepad_a,
+    &input.gamepad_b,
+    &input.gamepad_x,
+    &input.gamepad_y,
+    &input.gamepad_left_trigger,
+    &input.gamepad_right_trigger
+};
+
+bool start_recording(utf8* file_name, u64 seed, u32 tick_rate, u32 start_mode) {
+    assert(recording.mode == RECORDING_MODE_NONE);
+
+    recording.file = fopen(file_name, "wb");
+    if (!recording.file) {
+        printf("Failed to open recording '%s'\n", file_name);
+        return false;
+    }
+
+    recording.header.seed       = seed;
+    recording.header.tick_rate  = tick_rate;
+    recording.header.start_mode = start_mode;
+
+    // @note: The frame count is filled in by stop_recording
+    fwrite(&recording.header, size_of(Recording_Header), 1, recording.file);
+
+    recording.mode  = RECORDING_MODE_RECORD;
+    recording.frame = 0;
+
+    printf("Recording to '%s'\n", file_name);
+    return true;
+}
+
+bool start_replay(utf8* file_name, Recording_Header* header) {
+    assert(recording.mode == RECORDING_MODE_NONE);
+
+    recording.file = fopen(file_name, "rb");
+    if (!recording.file) {
+        printf("Failed to open recording '%s'\n", file_name);
+        return false;
+    }
+
+    bool is_valid = fread(&recording.header, size_of(Recording_Header), 1, recording.file) == 1;
+    
+    is_valid = is_valid && recording.header.magic   == RECORDING_MAGIC;
+    is_valid = is_valid && recording.header.version == RECORDING_VERSION;
+
+    if (!is_valid) {
+        printf("'%s' is not a recording\n", file_name);
+
+        fclose(recording.file);
+        recording.file = null;
+
+        return false;
+    }
+
+    *header = recording.header;
+
+    recording.mode  = RECORDING_MODE_REPLAY;
+    recording.frame = 0;
+
+    printf("Replaying '%s' (%u frames)\n", file_name, recording.header.frame_count);
+    return true;
+}
+
+void stop_recording() {
+    if (recording.mode == RECORDING_MODE_RECORD) {
+        recording.header.frame_count = recording.frame;
+
+        fseek(recording.file, 0, SEEK_SET);
+        fwrite(&recording.header, size_of(Recording_Header), 1, recording.file);
+    }
+
+    if (recording.file) fclose(recording.file);
+
+    recording.file = null;
+    recording.mode = RECORDING_MODE_NONE;
+}
+
+void record_frame() {
+    Recorded_Frame frame;
+
+    frame.now           = timers.now;
+    frame.delta         = timers.delta;
+    frame.window_width  = (u16) platform.window_width;
+    frame.window_height = (u16) platform.window_height;
+
+    for (u32 i = 0; i < count_of(recorded_keys); i++) {
+        if (recorded_keys[i]->held) frame.held_keys |= 1 << i;
+        if (recorded_keys[i]->down) frame.down_keys |= 1 << i;
+        if (recorded_keys[i]->up)   frame.up_keys   |= 1 << i;
+    }
+
+    frame.mouse_x = input.mouse_x;
+    frame.mouse_y = input.mouse_y;
+
+    frame.gamepad_left_x  = input.gamepad_left_x;
+    frame.gamepad_left_y  = input.gamepad_left_y;
+    frame.gamepad_right_x = input.gamepad_right_x;
+    frame.gamepad_right_y = input.gamepad_right_y;
+
+    fwrite(&frame, size_of(Recorded_Frame), 1, recording.file);
+    recording.frame += 1;
+}
+
+void replay_frame() {
+    Recorded_Frame frame;
+
+    if (fread(&frame, size_of(Recorded_Frame), 1, recording.file) != 1) {
+        printf("Replay finished after %u frames\n", recording.frame);
+        
+        platform.should_quit = true;
+        return;
+    }
+
+    timers.now   = frame.now;
+    timers.delta = frame.delta;
+
+    platform.window_width  = frame.window_width;
+    platform.window_height = frame.window_height;
+
+    for (u32 i = 0; i < count_of(recorded_keys); i++) {
+        recorded_keys[i]->held = (frame.held_keys & (1 << i)) != 0;
+        recorded_keys[i]->down = (frame.down_keys & (1 << i)) != 0;
+        recorded_keys[i]->up   = (frame.up_keys   & (1 << i)) != 0;
+    }
+
+    input.mouse_x = frame.mouse_x;
+    input.mouse_y = frame.mouse_y;
+
+    input.gamepad_left_x  = frame.gamepad_left_x;
+    input.gamepad_left_y  = frame.gamepad_left_y;
+    input.gamepad_right_x = frame.gamepad_right_x;
+    input.gamepad_right_y = frame.gamepad_right_y;
+
+    recording.frame += 1;
+}
+
 void init_platform() {
     #if OS_WINDOWS
         platform.process_heap = GetProcessHeap();
     #endif
 
-    platform.temp_memory = (u8*) heap_alloc(TEMP_MEMORY_SIZE);
+    frame_arena = make_arena("Frame", FRAME_ARENA_SIZE);
+    mode_arena  = make_arena("Mode",  MODE_ARENA_SIZE);
 
-    #if OS_WINDOWS
+    #if HEADLESS
+        platform.window_width  = 1600;
+        platform.window_height = 900;
+        platform.is_active     = true;
+    #elif OS_WINDOWS
         LARGE_INTEGER frequency;
         QueryPerformanceFrequency(&frequency);
 
@@ -623,17 +1794,31 @@ void init_platform() {
         glXMakeCurrent(platform.display, platform.window, platform.gl_context);
     #endif
 
-    toggle_fullscreen();
+    #if !HEADLESS
+        toggle_fullscreen();
+    #endif
 }
 
 void show_window() {
-    ShowWindow(platform.window, SW_SHOW);
+    #if OS_WINDOWS && !HEADLESS
+        ShowWindow(platform.window, SW_SHOW);
+    #endif
 }
 
 void update_platform() {
-    platform.temp_memory_allocated = 0;
+    reset_arena(&frame_arena);
 
-    #if OS_WINDOWS
+    #if HEADLESS
+        timers.delta = HEADLESS_FRAME_DELTA;
+        timers.now  += timers.delta;
+
+        apply_input_script(platform.frame);
+        platform.frame += 1;
+
+        if (platform.frame_limit && platform.frame >= platform.frame_limit) {
+            platform.should_quit = true;
+        }
+    #elif OS_WINDOWS
         LARGE_INTEGER ticks;
         QueryPerformanceCounter(&ticks);
 
@@ -716,10 +1901,27 @@ void update_platform() {
     #endif
 
     if (timers.delta > 0.1f) timers.delta = 0.1f;
+
+    switch (recording.mode) {
+        case RECORDING_MODE_NONE: {
+            break;
+        }
+        case RECORDING_MODE_RECORD: {
+            record_frame();
+            break;
+        }
+        case RECORDING_MODE_REPLAY: {
+            replay_frame();
+            break;
+        }
+        invalid_default_case();
+    }
 }
 
 void swap_buffers() {
-    #if OS_WINDOWS
+    #if HEADLESS
+        return;
+    #elif OS_WINDOWS
         SwapBuffers(platform.device_context);
     #elif OS_LINUX
         glXSwapBuffers(platform.display, platform.window);
@@ -33,13 +33,22 @@ Sound load_sound(utf8* file_name) {
     Sound sound;
     sound.file_name = file_name;
 
+    short* decoded_samples = null;
+
     sound.samples_count = stb_vorbis_decode_filename(
         (char*)   sound.file_name, 
         (int*)    &sound.channels, 
         (int*)    &sound.sample_rate, 
-        (short**) &sound.samples);
+        &decoded_samples);
 
     if (sound.samples_count != -1) {
+        // @note: stb_vorbis decodes with malloc, move the samples onto our heap so they are counted
+        u32 samples_size = sound.samples_count * sound.channels * size_of(short);
+
+        sound.samples = (u8*) heap_alloc(samples_size);
+        memcpy(sound.samples, decoded_samples, samples_size);
+        free(decoded_samples);
+
         printf("Loaded sound '%s'\n", sound.file_name);
         sound.is_valid = true;
     }
@@ -143,12 +152,14 @@ void set_volume(Playing_Sound* playing_sound, float volume) {
 bool sound_is_on;
 
 void toggle_sound() {
-    if (sound_is_on) {
-        mastering_voice->SetVolume(0.0f);
-    }
-    else {
-        mastering_voice->SetVolume(1.0f);
-    }
+    #if OS_WINDOWS
+        if (sound_is_on) {
+            mastering_voice->SetVolume(0.0f);
+        }
+        else {
+            mastering_voice->SetVolume(1.0f);
+        }
+    #endif
 
     sound_is_on = !sound_is_on;
 }
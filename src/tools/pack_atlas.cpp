@@ -0,0 +1,496 @@
+//
+// Offline sprite atlas packer. Run it from the 'data' directory with an output name
+// and the sprites to pack, for example:
+//
+//     ..\build\pack_atlas.exe sprites/atlas sprites/*.png
+//
+// The sprites are shelf packed into as many atlas pages as needed. Every sprite is
+// padded and its edge pixels are extruded into the padding so linear filtering never
+// samples a neighbour. Each page is written as '<output>_NN.png' and the table the
+// game reads to find sprites is written as '<output>.txt'.
+//
+// The pages are written with a small deflate encoder (fixed huffman codes and lz77
+// matches) so this doesn't need a png writer on top of stb_image.
+//
+
+#define _CRT_SECURE_NO_WARNINGS 1
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef uint8_t  u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int32_t  i32;
+typedef char     utf8;
+
+#define null 0
+
+#define size_of(type)   ((u32) sizeof(type))
+#define count_of(array) (size_of(array) / size_of(array[0]))
+
+#pragma warning(push)
+    #pragma warning(disable: 4244)
+    #pragma warning(disable: 4456)
+    #pragma warning(disable: 4459)
+    #pragma warning(disable: 4505)
+
+    #define STB_IMAGE_IMPLEMENTATION
+    #define STBI_ONLY_PNG
+
+    #include "../../lib/stb_image.h"
+#pragma warning(pop)
+
+#define DEFAULT_PAGE_SIZE 1024
+#define SPRITE_PADDING    2
+
+struct Packed_Sprite {
+    utf8* file_name = null;
+    u8*   image     = null;
+
+    u32 width  = 0;
+    u32 height = 0;
+
+    u32 page = 0;
+    u32 x    = 0;
+    u32 y    = 0;
+};
+
+int compare_sprite_heights(const void* a, const void* b) {
+    Packed_Sprite* sprite_a = (Packed_Sprite*) a;
+    Packed_Sprite* sprite_b = (Packed_Sprite*) b;
+
+    if (sprite_a->height != sprite_b->height) {
+        return sprite_a->height > sprite_b->height ? -1 : 1;
+    }
+
+    return strcmp(sprite_a->file_name, sprite_b->file_name);
+}
+
+//
+// Png writing
+//
+
+u32 crc_table[256];
+
+void make_crc_table() {
+    for (u32 i = 0; i < 256; i++) {
+        u32 crc = i;
+
+        for (u32 j = 0; j < 8; j++) {
+            crc = (crc & 1) ? 0xEDB88320 ^ (crc >> 1) : crc >> 1;
+        }
+
+        crc_table[i] = crc;
+    }
+}
+
+u32 update_crc(u32 crc, u8* data, u32 size) {
+    for (u32 i = 0; i < size; i++) {
+        crc = crc_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+
+    return crc;
+}
+
+struct Byte_Buffer {
+    u8* data     = null;
+    u32 count    = 0;
+    u32 capacity = 0;
+};
+
+void push_byte(Byte_Buffer* buffer, u8 byte) {
+    if (buffer->count == buffer->capacity) {
+        buffer->capacity = buffer->capacity ? buffer->capacity * 2 : 4096;
+        buffer->data     = (u8*) realloc(buffer->data, buffer->capacity);
+    }
+
+    buffer->data[buffer->count++] = byte;
+}
+
+void push_u32_big_endian(Byte_Buffer* buffer, u32 value) {
+    push_byte(buffer, (u8) (value >> 24));
+    push_byte(buffer, (u8) (value >> 16));
+    push_byte(buffer, (u8) (value >>  8));
+    push_byte(buffer, (u8) (value >>  0));
+}
+
+struct Bit_Writer {
+    Byte_Buffer* buffer = null;
+
+    u32 bits      = 0;
+    u32 bit_count = 0;
+};
+
+void write_bits(Bit_Writer* writer, u32 value, u32 count) {
+    writer->bits      |= value << writer->bit_count;
+    writer->bit_count += count;
+
+    while (writer->bit_count >= 8) {
+        push_byte(writer->buffer, (u8) writer->bits);
+
+        writer->bits      >>= 8;
+        writer->bit_count  -= 8;
+    }
+}
+
+void flush_bits(Bit_Writer* writer) {
+    if (writer->bit_count) {
+        push_byte(writer->buffer, (u8) writer->bits);
+    }
+
+    writer->bits      = 0;
+    writer->bit_count = 0;
+}
+
+// @note: Huffman codes are stored most significant bit first, everything else least significant bit first
+void write_huffman_code(Bit_Writer* writer, u32 code, u32 length) {
+    u32 reversed = 0;
+
+    for (u32 i = 0; i < length; i++) {
+        reversed = (reversed << 1) | ((code >> i) & 1);
+    }
+
+    write_bits(writer, reversed, length);
+}
+
+void write_fixed_symbol(Bit_Writer* writer, u32 symbol) {
+    if      (symbol < 144) write_huffman_code(writer, 0x30  + symbol,         8);
+    else if (symbol < 256) write_huffman_code(writer, 0x190 + symbol - 144,   9);
+    else if (symbol < 280) write_huffman_code(writer, 0x00  + symbol - 256,   7);
+    else                   write_huffman_code(writer, 0xC0  + symbol - 280,   8);
+}
+
+u32 length_bases[]  = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+u32 length_extras[] = { 0, 0, 0, 0, 0, 0, 0,  0,  1,  1,  1,  1,  2,  2,  2,  2,  3,  3,  3,  3,  4,  4,  4,   4,   5,   5,   5,   5,   0 };
+
+u32 distance_bases[]  = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+u32 distance_extras[] = { 0, 0, 0, 0, 1, 1, 2,  2,  3,  3,  4,  4,  5,  5,   6,   6,   7,   7,   8,   8,    9,    9,   10,   10,   11,   11,   12,    12,    13,    13 };
+
+void write_match(Bit_Writer* writer, u32 length, u32 distance) {
+    u32 length_code = count_of(length_bases) - 1;
+    while (length_bases[length_code] > length) length_code -= 1;
+
+    write_fixed_symbol(writer, 257 + length_code);
+    write_bits(writer, length - length_bases[length_code], length_extras[length_code]);
+
+    u32 distance_code = count_of(distance_bases) - 1;
+    while (distance_bases[distance_code] > distance) distance_code -= 1;
+
+    write_huffman_code(writer, distance_code, 5);
+    write_bits(writer, distance - distance_bases[distance_code], distance_extras[distance_code]);
+}
+
+#define WINDOW_SIZE  32768
+#define HASH_SIZE    (1 << 15)
+#define MIN_MATCH    3
+#define MAX_MATCH    258
+#define MAX_CHAIN    64
+
+u32 hash_bytes(u8* data) {
+    return ((data[0] << 10) ^ (data[1] << 5) ^ data[2]) & (HASH_SIZE - 1);
+}
+
+void write_zlib(Byte_Buffer* buffer, u8* data, u32 size) {
+    // @note: Deflate with a 32k window, no preset dictionary, fastest compression level hint
+    push_byte(buffer, 0x78);
+    push_byte(buffer, 0x01);
+
+    Bit_Writer writer;
+    writer.buffer = buffer;
+
+    write_bits(&writer, 1, 1);
+    write_bits(&writer, 1, 2);
+
+    i32* head     = (i32*) malloc(HASH_SIZE * size_of(i32));
+    i32* previous = (i32*) malloc(size * size_of(i32));
+
+    for (u32 i = 0; i < HASH_SIZE; i++) head[i] = -1;
+
+    u32 cursor = 0;
+    while (cursor < size) {
+        u32 best_length   = 0;
+        u32 best_distance = 0;
+
+        if (cursor + MIN_MATCH <= size) {
+            u32 max_length = size - cursor;
+            if (max_length > MAX_MATCH) max_length = MAX_MATCH;
+
+            i32 candidate = head[hash_bytes(data + cursor)];
+
+            for (u32 chain = 0; chain < MAX_CHAIN && candidate >= 0; chain++) {
+                u32 distance = cursor - (u32) candidate;
+                if (distance > WINDOW_SIZE) break;
+
+                u32 length = 0;
+                while (length < max_length && data[candidate + length] == data[cursor + length]) {
+                    length += 1;
+                }
+
+                if (length > best_length) {
+                    best_length   = length;
+                    best_distance = distance;
+
+                    if (length == max_length) break;
+                }
+
+                candidate = previous[candidate];
+            }
+        }
+
+        u32 advance = 1;
+
+        if (best_length >= MIN_MATCH) {
+            write_match(&writer, best_length, best_distance);
+            advance = best_length;
+        }
+        else {
+            write_fixed_symbol(&writer, data[cursor]);
+        }
+
+        for (u32 i = 0; i < advance; i++, cursor++) {
+            if (cursor + MIN_MATCH <= size) {
+                u32 hash = hash_bytes(data + cursor);
+
+                previous[cursor] = head[hash];
+                head[hash]       = (i32) cursor;
+            }
+        }
+    }
+
+    write_fixed_symbol(&writer, 256);
+    flush_bits(&writer);
+
+    free(head);
+    free(previous);
+
+    u32 a = 1;
+    u32 b = 0;
+
+    for (u32 i = 0; i < size; i++) {
+        a = (a + data[i]) % 65521;
+        b = (b + a)       % 65521;
+    }
+
+    push_u32_big_endian(buffer, (b << 16) | a);
+}
+
+void write_chunk(FILE* file, utf8* type, u8* data, u32 size) {
+    Byte_Buffer header;
+
+    push_u32_big_endian(&header, size);
+    for (u32 i = 0; i < 4; i++) push_byte(&header, (u8) type[i]);
+
+    u32 crc = update_crc(0xFFFFFFFF, header.data + 4, 4);
+    crc = update_crc(crc, data, size) ^ 0xFFFFFFFF;
+
+    Byte_Buffer footer;
+    push_u32_big_endian(&footer, crc);
+
+    fwrite(header.data, 1, header.count, file);
+    fwrite(data, 1, size, file);
+    fwrite(footer.data, 1, footer.count, file);
+
+    free(header.data);
+    free(footer.data);
+}
+
+bool write_png(utf8* file_name, u8* pixels, u32 width, u32 height) {
+    FILE* file = fopen(file_name, "wb");
+    if (!file) return false;
+
+    u8 signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    fwrite(signature, 1, size_of(signature), file);
+
+    Byte_Buffer header;
+
+    push_u32_big_endian(&header, width);
+    push_u32_big_endian(&header, height);
+
+    push_byte(&header, 8); // Bit depth
+    push_byte(&header, 6); // Rgba
+    push_byte(&header, 0); // Compression
+    push_byte(&header, 0); // Filter
+    push_byte(&header, 0); // Interlace
+
+    write_chunk(file, "IHDR", header.data, header.count);
+
+    // @note: Every scanline is stored unfiltered, the lz77 matches take care of the transparent runs
+    u32 row_size      = width * 4;
+    u32 scanlines_size = (row_size + 1) * height;
+
+    u8* scanlines = (u8*) malloc(scanlines_size);
+
+    for (u32 y = 0; y < height; y++) {
+        u8* row = scanlines + y * (row_size + 1);
+
+        row[0] = 0;
+        memcpy(row + 1, pixels + y * row_size, row_size);
+    }
+
+    Byte_Buffer compressed;
+    write_zlib(&compressed, scanlines, scanlines_size);
+
+    write_chunk(file, "IDAT", compressed.data, compressed.count);
+    write_chunk(file, "IEND", null, 0);
+
+    free(header.data);
+    free(compressed.data);
+    free(scanlines);
+
+    fclose(file);
+    return true;
+}
+
+//
+// Packing
+//
+
+void blit_sprite(u8* page_pixels, u32 page_size, Packed_Sprite* sprite) {
+    i32 padding = SPRITE_PADDING;
+
+    // @note: The padding around the sprite repeats its edge pixels
+    for (i32 y = -padding; y < (i32) sprite->height + padding; y++) {
+        for (i32 x = -padding; x < (i32) sprite->width + padding; x++) {
+            i32 source_x = x < 0 ? 0 : (x >= (i32) sprite->width  ? sprite->width  - 1 : x);
+            i32 source_y = y < 0 ? 0 : (y >= (i32) sprite->height ? sprite->height - 1 : y);
+
+            u8* source      = sprite->image + (source_y * sprite->width + source_x) * 4;
+            u8* destination = page_pixels + ((sprite->y + y) * page_size + (sprite->x + x)) * 4;
+
+            memcpy(destination, source, 4);
+        }
+    }
+}
+
+int main(int argument_count, utf8** arguments) {
+    if (argument_count < 3) {
+        printf("Usage: pack_atlas <output name> <sprite.png>...\n");
+        return 1;
+    }
+
+    make_crc_table();
+
+    utf8* output_name = arguments[1];
+    u32   page_size   = DEFAULT_PAGE_SIZE;
+
+    Packed_Sprite* sprites = (Packed_Sprite*) calloc(argument_count, size_of(Packed_Sprite));
+    u32 sprite_count = 0;
+
+    size_t output_name_length = strlen(output_name);
+
+    for (i32 i = 2; i < argument_count; i++) {
+        utf8* file_name = arguments[i];
+
+        // @note: The game looks sprites up with forward slashes
+        for (utf8* cursor = file_name; *cursor; cursor++) {
+            if (*cursor == '\\') *cursor = '/';
+        }
+
+        // @note: Don't pack the pages of a previous run
+        if (strncmp(file_name, output_name, output_name_length) == 0) continue;
+
+        Packed_Sprite* sprite = &sprites[sprite_count];
+
+        i32 width;
+        i32 height;
+
+        sprite->image = stbi_load(file_name, &width, &height, null, 4);
+        if (!sprite->image) {
+            printf("Failed to load sprite '%s'\n", file_name);
+            return 1;
+        }
+
+        sprite->file_name = file_name;
+        sprite->width     = (u32) width;
+        sprite->height    = (u32) height;
+
+        if (sprite->width + 2 * SPRITE_PADDING > page_size || sprite->height + 2 * SPRITE_PADDING > page_size) {
+            printf("Sprite '%s' does not fit in a %ux%u page\n", file_name, page_size, page_size);
+            return 1;
+        }
+
+        sprite_count += 1;
+    }
+
+    qsort(sprites, sprite_count, size_of(Packed_Sprite), compare_sprite_heights);
+
+    u32 page_count   = 1;
+    u32 shelf_x      = 0;
+    u32 shelf_y      = 0;
+    u32 shelf_height = 0;
+
+    for (u32 i = 0; i < sprite_count; i++) {
+        Packed_Sprite* sprite = &sprites[i];
+
+        u32 padded_width  = sprite->width  + 2 * SPRITE_PADDING;
+        u32 padded_height = sprite->height + 2 * SPRITE_PADDING;
+
+        if (shelf_x + padded_width > page_size) {
+            shelf_x      = 0;
+            shelf_y     += shelf_height;
+            shelf_height = 0;
+        }
+
+        if (shelf_y + padded_height > page_size) {
+            page_count  += 1;
+            shelf_x      = 0;
+            shelf_y      = 0;
+            shelf_height = 0;
+        }
+
+        sprite->page = page_count - 1;
+        sprite->x    = shelf_x + SPRITE_PADDING;
+        sprite->y    = shelf_y + SPRITE_PADDING;
+
+        shelf_x += padded_width;
+        if (padded_height > shelf_height) shelf_height = padded_height;
+    }
+
+    utf8 table_name[512];
+    snprintf(table_name, size_of(table_name), "%s.txt", output_name);
+
+    FILE* table_file = fopen(table_name, "wb");
+    if (!table_file) {
+        printf("Failed to open '%s'\n", table_name);
+        return 1;
+    }
+
+    fprintf(table_file, "pages=%u\n", page_count);
+
+    u8* page_pixels = (u8*) malloc(page_size * page_size * 4);
+
+    for (u32 page = 0; page < page_count; page++) {
+        memset(page_pixels, 0, page_size * page_size * 4);
+
+        for (u32 i = 0; i < sprite_count; i++) {
+            if (sprites[i].page == page) blit_sprite(page_pixels, page_size, &sprites[i]);
+        }
+
+        utf8 page_name[512];
+        snprintf(page_name, size_of(page_name), "%s_%02u.png", output_name, page);
+
+        if (!write_png(page_name, page_pixels, page_size, page_size)) {
+            printf("Failed to write '%s'\n", page_name);
+            return 1;
+        }
+
+        fprintf(table_file, "page=%s %u %u\n", page_name, page_size, page_size);
+        printf("Wrote atlas page '%s'\n", page_name);
+    }
+
+    fprintf(table_file, "sprites=%u\n", sprite_count);
+
+    for (u32 i = 0; i < sprite_count; i++) {
+        Packed_Sprite* sprite = &sprites[i];
+        fprintf(table_file, "sprite=%s %u %u %u %u %u\n", sprite->file_name, sprite->page, sprite->x, sprite->y, sprite->width, sprite->height);
+    }
+
+    fclose(table_file);
+    printf("Packed %u sprites into %u page(s)\n", sprite_count, page_count);
+
+    return 0;
+}